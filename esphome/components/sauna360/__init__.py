@@ -1,37 +1,522 @@
+import logging
+
 import esphome.codegen as cg
 import esphome.config_validation as cv
+import esphome.final_validate as fv
+from esphome import automation, pins
 from esphome.components import uart
-from esphome.const import CONF_ID
+from esphome.components.esp32 import (
+    VARIANT_ESP32,
+    VARIANT_ESP32S2,
+    add_idf_sdkconfig_option,
+    get_esp32_variant,
+)
+from esphome.const import (
+    CONF_DEVICE,
+    CONF_ID,
+    CONF_NAME,
+    CONF_PLATFORM,
+    CONF_PORT,
+)
+from esphome.core import CORE
 
-DEPENDENCIES = ["uart"]
+# uart: on ESP32 (through UART_DEVICE_SCHEMA); host builds open the bus
+# device themselves, see _bus_schema
 
 sauna360_ns = cg.esphome_ns.namespace("sauna360")
 SAUNA360Component = sauna360_ns.class_(
     "SAUNA360Component", cg.Component, uart.UARTDevice
 )
-Mode = sauna360_ns.enum("SAUNA360Component::Mode")
+Model = sauna360_ns.enum("Model", is_class=True)
+ApplyProfileAction = sauna360_ns.class_("ApplyProfileAction", automation.Action)
+DumpRegistersAction = sauna360_ns.class_("DumpRegistersAction", automation.Action)
+DiscoveryReportAction = sauna360_ns.class_(
+    "DiscoveryReportAction", automation.Action
+)
+ResetLatencyAction = sauna360_ns.class_("ResetLatencyAction", automation.Action)
+JournalDumpAction = sauna360_ns.class_("JournalDumpAction", automation.Action)
+JournalClearAction = sauna360_ns.class_("JournalClearAction", automation.Action)
+RecorderDumpAction = sauna360_ns.class_("RecorderDumpAction", automation.Action)
+RecorderTriggerAction = sauna360_ns.class_(
+    "RecorderTriggerAction", automation.Action
+)
+BenchmarkAction = sauna360_ns.class_("BenchmarkAction", automation.Action)
+
+_LOGGER = logging.getLogger(__name__)
 
+DOMAIN = "sauna360"
 CONF_SAUNA360_ID = "sauna360_id"
 
 CONF_MODEL = "model"
+# Each model selects a compile-time policy (model_policy.h); keep the feature
+# flags in sync with it. `auto` keeps the runtime policy and lets
+# ModelDetector pick one from the bus traffic.
 MODEL_OPTIONS = {
-    "pure": cg.RawExpression("esphome::sauna360::SAUNA360Component::Mode::PURE"),
-    "combi": cg.RawExpression("esphome::sauna360::SAUNA360Component::Mode::COMBI"),
-    "elite": cg.RawExpression("esphome::sauna360::SAUNA360Component::Mode::ELITE"),
+    "pure": "PURE",
+    "combi": "COMBI",
+    "elite": "ELITE",
+    "combi_elite": "COMBI_ELITE",
+    "auto": "AUTO",
 }
+FEATURE_HUMIDITY_STEP = "humidity_step"
+FEATURE_HUMIDITY_PERCENT = "humidity_percent"
+FEATURE_WATER_TANK = "water_tank"
+FEATURE_MODEL_DETECTION = "model_detection"
+FEATURE_AUX_RELAYS = "aux_relays"
+MODEL_FEATURES = {
+    "pure": set(),
+    "combi": {FEATURE_HUMIDITY_STEP, FEATURE_WATER_TANK, FEATURE_AUX_RELAYS},
+    "elite": {FEATURE_AUX_RELAYS},
+    "combi_elite": {FEATURE_HUMIDITY_PERCENT, FEATURE_WATER_TANK},
+    # Checked at runtime against the detected model
+    "auto": {
+        FEATURE_HUMIDITY_STEP,
+        FEATURE_HUMIDITY_PERCENT,
+        FEATURE_WATER_TANK,
+        FEATURE_AUX_RELAYS,
+        FEATURE_MODEL_DETECTION,
+    },
+}
+# Code behind each feature (sauna360.cpp); logged at codegen for the
+# features a fixed model compiles out
+FEATURE_CODE = {
+    FEATURE_HUMIDITY_STEP: "0x6001 step decode, set_humidity_step_number()",
+    FEATURE_HUMIDITY_PERCENT: "0x6001 percent decode, "
+    "set_humidity_percent_number()",
+    FEATURE_WATER_TANK: "0x7280 tank level decode",
+    FEATURE_AUX_RELAYS: "AUX relay logging in the 0x7180 decode",
+    FEATURE_MODEL_DETECTION: "ModelDetector and the runtime model policy",
+}
+# Entity keys per feature, filled by model_feature_validator() as the
+# platforms are loaded
+_FEATURE_ENTITIES = {}
 
-CONFIG_SCHEMA = (
-    cv.Schema(
-        {
-            cv.GenerateID(): cv.declare_id(SAUNA360Component),
-            cv.Optional(CONF_MODEL, default="pure"): cv.enum(MODEL_OPTIONS, lower=True),
-        }
+
+def model_feature_validator(features):
+    """Final validation for platforms: reject entities (keys of `features`)
+    that the parent's model compiles out."""
+    for key, feature in features.items():
+        _FEATURE_ENTITIES.setdefault(feature, []).append(key)
+
+    def validator(config):
+        full_config = fv.full_config.get()
+        path = full_config.get_path_for_id(config[CONF_SAUNA360_ID])[:-1]
+        model = full_config.get_config_for_path(path)[CONF_MODEL]
+        for key, feature in features.items():
+            if key in config and feature not in MODEL_FEATURES[model]:
+                raise cv.Invalid(
+                    f"'{key}' is not supported by model '{model}'", path=[key]
+                )
+        return config
+
+    return validator
+
+
+CONF_DETECTION_CYCLES = "detection_cycles"
+CONF_ADAPTIVE_IFG = "adaptive_ifg"
+CONF_VIRTUAL_PANEL = "virtual_panel"
+CONF_ARBITRATION = "arbitration"
+CONF_ANOMALY_DETECTION = "anomaly_detection"
+CONF_STUCK_TIME = "stuck_time"
+CONF_MIN_COIL_PERIOD = "min_coil_period"
+CONF_NODE_ID = "node_id"
+CONF_SLOT_SPACING = "slot_spacing"
+CONF_BUS_TIMEOUT_CYCLES = "bus_timeout_cycles"
+CONF_DISCOVERY = "discovery"
+CONF_CODES = "codes"
+CONF_WINDOW = "window"
+CONF_RX_TASK_STACK_SIZE = "rx_task_stack_size"
+CONF_TX_QUEUE_SIZE = "tx_queue_size"
+CONF_HEAP_AUDIT = "heap_audit"
+CONF_RX_DMA = "rx_dma"
+CONF_CYCLE_LEARNER = "cycle_learner"
+CONF_RS485 = "rs485"
+CONF_DE_PIN = "de_pin"
+CONF_MAX_RETRIES = "max_retries"
+CONF_POWER_SAVE = "power_save"
+CONF_FRAME_STREAM = "frame_stream"
+CONF_JOURNAL = "journal"
+CONF_PARTITION = "partition"
+CONF_FLIGHT_RECORDER = "flight_recorder"
+CONF_RECORDS = "records"
+CONF_PRE_TRIGGER = "pre_trigger"
+CONF_POST_TRIGGER = "post_trigger"
+CONF_TRIGGERS = "triggers"
+CONF_CRC_ERRORS = "crc_errors"
+CONF_CRC_WINDOW = "crc_window"
+CONF_HEATER_STATE = "heater_state"
+CONF_MIN_CPU_FREQUENCY = "min_cpu_frequency"
+CONF_LIGHT_SLEEP = "light_sleep"
+CONF_QUIET_TIME = "quiet_time"
+CONF_PROFILES = "profiles"
+CONF_PROFILE = "profile"
+CONF_BATH_TEMPERATURE = "bath_temperature"
+CONF_BATH_TIME = "bath_time"
+CONF_MAX_BATH_TEMPERATURE = "max_bath_temperature"
+CONF_HUMIDITY_STEP = "humidity_step"
+CONF_HUMIDITY_PERCENT = "humidity_percent"
+CONF_HEATER = "heater"
+CONF_START_RATE = "start_rate"
+CONF_MAX_RATE = "max_rate"
+CONF_STEP_DURATION = "step_duration"
+
+PROFILE_SCHEMA = cv.Schema(
+    {
+        cv.Required(CONF_NAME): cv.string_strict,
+        cv.Optional(CONF_BATH_TEMPERATURE): cv.float_range(min=40, max=110),
+        cv.Optional(CONF_BATH_TIME): cv.float_range(min=1, max=360),
+        cv.Optional(CONF_MAX_BATH_TEMPERATURE): cv.float_range(min=40, max=110),
+        cv.Exclusive(CONF_HUMIDITY_STEP, "humidity"): cv.float_range(min=0, max=10),
+        cv.Exclusive(CONF_HUMIDITY_PERCENT, "humidity"): cv.float_range(
+            min=0, max=100
+        ),
+        cv.Optional(CONF_HEATER): cv.boolean,
+    }
+)
+
+
+# `custom:` register fields, shared by the sensor, binary_sensor and
+# text_sensor platforms
+CONF_CUSTOM = "custom"
+CONF_CODE = "code"
+CONF_DIRECTION = "direction"
+CONF_BIT_OFFSET = "bit_offset"
+CONF_BIT_WIDTH = "bit_width"
+CONF_SIGNED = "signed"
+CONF_SCALE = "scale"
+CONF_OFFSET = "offset"
+CUSTOM_FIELDS_MAX = 16  # CustomRegisters::MAX_FIELDS, for all platforms
+CUSTOM_FIELD_DOMAINS = ("sensor", "binary_sensor", "text_sensor")
+DIRECTIONS = {"heater": 0, "panel": 1}  # RegisterMap::Direction
+
+
+def _validate_custom_field(config):
+    if config[CONF_BIT_OFFSET] + config[CONF_BIT_WIDTH] > 32:
+        raise cv.Invalid(
+            f"{CONF_BIT_OFFSET} + {CONF_BIT_WIDTH} must not exceed 32",
+            path=[CONF_BIT_WIDTH],
+        )
+    return config
+
+
+def custom_field_schema(entity_schema, bit_width=32, scaled=True):
+    schema = {
+        cv.Required(CONF_CODE): cv.hex_uint16_t,
+        cv.Optional(CONF_DIRECTION, default="heater"): cv.one_of(
+            *DIRECTIONS, lower=True
+        ),
+        cv.Optional(CONF_BIT_OFFSET, default=0): cv.int_range(min=0, max=31),
+        cv.Optional(CONF_BIT_WIDTH, default=bit_width): cv.int_range(min=1, max=32),
+    }
+    if scaled:
+        schema.update(
+            {
+                cv.Optional(CONF_SIGNED, default=False): cv.boolean,
+                cv.Optional(CONF_SCALE, default=1.0): cv.float_,
+                cv.Optional(CONF_OFFSET, default=0.0): cv.float_,
+            }
+        )
+    return cv.All(
+        cv.ensure_list(cv.All(entity_schema.extend(schema), _validate_custom_field)),
+        cv.Length(max=CUSTOM_FIELDS_MAX),
     )
-    .extend(uart.UART_DEVICE_SCHEMA)
-    .extend(cv.COMPONENT_SCHEMA)
+
+
+def _validate_custom_total(config):
+    """The field table is shared: the limit applies to the sum of the
+    `custom:` lists of all platforms bound to this hub."""
+    full_config = fv.full_config.get()
+    total = 0
+    for domain in CUSTOM_FIELD_DOMAINS:
+        for platform in full_config.get(domain, []):
+            if (
+                platform.get(CONF_PLATFORM) == DOMAIN
+                and platform[CONF_SAUNA360_ID].id == config[CONF_ID].id
+            ):
+                total += len(platform.get(CONF_CUSTOM, []))
+    if total > CUSTOM_FIELDS_MAX:
+        raise cv.Invalid(
+            f"{total} custom fields across {', '.join(CUSTOM_FIELD_DOMAINS)}; "
+            f"at most {CUSTOM_FIELDS_MAX} per {DOMAIN} hub"
+        )
+    return config
+
+
+async def register_custom_field(parent, config, sink):
+    cg.add_define("SAUNA360_CUSTOM_REGISTERS")
+    cg.add(
+        parent.add_custom_field(
+            DIRECTIONS[config[CONF_DIRECTION]],
+            config[CONF_CODE],
+            config[CONF_BIT_OFFSET],
+            config[CONF_BIT_WIDTH],
+            config.get(CONF_SIGNED, False),
+            config.get(CONF_SCALE, 1.0),
+            config.get(CONF_OFFSET, 0.0),
+            sink,
+        )
+    )
+
+
+def _validate_profile_models(config):
+    features = MODEL_FEATURES[config[CONF_MODEL]]
+    for profile in config.get(CONF_PROFILES, []):
+        for key, feature in (
+            (CONF_HUMIDITY_STEP, FEATURE_HUMIDITY_STEP),
+            (CONF_HUMIDITY_PERCENT, FEATURE_HUMIDITY_PERCENT),
+        ):
+            if key in profile and feature not in features:
+                raise cv.Invalid(
+                    f"Profile '{profile[CONF_NAME]}': '{key}' is not supported "
+                    f"by model '{config[CONF_MODEL]}'"
+                )
+    return config
+
+
+def _validate_detection(config):
+    if CONF_DETECTION_CYCLES in config and config[CONF_MODEL] != "auto":
+        raise cv.Invalid(
+            f"'{CONF_DETECTION_CYCLES}' requires 'model: auto'",
+            path=[CONF_DETECTION_CYCLES],
+        )
+    return config
+
+
+def _validate_virtual_panel(config):
+    # The IFG calibrator measures gaps after the physical panel's EOF
+    if config[CONF_VIRTUAL_PANEL] and config[CONF_ADAPTIVE_IFG]:
+        raise cv.Invalid(
+            f"'{CONF_ADAPTIVE_IFG}' cannot be used with '{CONF_VIRTUAL_PANEL}'"
+        )
+    # Its windows are the physical panel's acks
+    if config[CONF_VIRTUAL_PANEL] and config[CONF_CYCLE_LEARNER]:
+        raise cv.Invalid(
+            f"'{CONF_CYCLE_LEARNER}' cannot be used with '{CONF_VIRTUAL_PANEL}'"
+        )
+    # Without a physical panel there is no shared slot to arbitrate
+    if config[CONF_VIRTUAL_PANEL] and CONF_ARBITRATION in config:
+        raise cv.Invalid(
+            f"'{CONF_ARBITRATION}' cannot be used with '{CONF_VIRTUAL_PANEL}'"
+        )
+    return config
+
+
+# These use ESP-IDF facilities (flash partitions, lwIP, power management,
+# UHCI, RS485 mode of the UART) that the host build does not provide
+_ESP32_ONLY = (
+    CONF_JOURNAL,
+    CONF_FLIGHT_RECORDER,
+    CONF_FRAME_STREAM,
+    CONF_POWER_SAVE,
+    CONF_RX_DMA,
+    CONF_RS485,
+)
+
+
+def _validate_host(config):
+    if not CORE.is_host:
+        return config
+    for key in _ESP32_ONLY:
+        if config.get(key):
+            raise cv.Invalid(f"'{key}' is not available on the host platform")
+    return config
+
+
+def _validate_rx_dma(config):
+    if not config[CONF_RX_DMA]:
+        return config
+    # The IDF UHCI driver runs on GDMA
+    if get_esp32_variant() in (VARIANT_ESP32, VARIANT_ESP32S2):
+        raise cv.Invalid(
+            f"'{CONF_RX_DMA}' needs an ESP32 variant with GDMA (S3, C3, C6, ...)"
+        )
+    # The calibrator needs the arrival time of every byte
+    if config[CONF_ADAPTIVE_IFG]:
+        raise cv.Invalid(
+            f"'{CONF_ADAPTIVE_IFG}' cannot be used with '{CONF_RX_DMA}'"
+        )
+    # UHCI replaces the UART driver that runs the RS485 mode
+    if CONF_RS485 in config:
+        raise cv.Invalid(f"'{CONF_RS485}' cannot be used with '{CONF_RX_DMA}'")
+    # Both send into a gap on their own timing and rely on seeing a frame
+    # that has started; with DMA it only shows up once it has ended
+    if config[CONF_VIRTUAL_PANEL]:
+        raise cv.Invalid(
+            f"'{CONF_VIRTUAL_PANEL}' cannot be used with '{CONF_RX_DMA}'"
+        )
+    if CONF_ARBITRATION in config:
+        raise cv.Invalid(
+            f"'{CONF_ARBITRATION}' cannot be used with '{CONF_RX_DMA}'"
+        )
+    return config
+
+
+def _validate_profiles(profiles):
+    names = [p[CONF_NAME] for p in profiles]
+    for name in names:
+        if names.count(name) > 1:
+            raise cv.Invalid(f"Duplicate bath profile name '{name}'")
+    return profiles
+
+
+_BASE_SCHEMA = cv.Schema(
+    {
+        cv.GenerateID(): cv.declare_id(SAUNA360Component),
+        cv.Optional(CONF_MODEL, default="pure"): cv.one_of(
+            *MODEL_OPTIONS, lower=True
+        ),
+        cv.Optional(CONF_DETECTION_CYCLES): cv.int_range(min=1, max=20),
+        cv.Optional(CONF_ADAPTIVE_IFG, default=False): cv.boolean,
+        cv.Optional(CONF_VIRTUAL_PANEL, default=False): cv.boolean,
+        cv.Optional(CONF_ANOMALY_DETECTION): cv.Schema(
+            {
+                cv.Optional(
+                    CONF_STUCK_TIME, default="10min"
+                ): cv.positive_time_period_milliseconds,
+                cv.Optional(
+                    CONF_MIN_COIL_PERIOD, default="60s"
+                ): cv.positive_time_period_milliseconds,
+            }
+        ),
+        cv.Optional(CONF_ARBITRATION): cv.Schema(
+            {
+                cv.Required(CONF_NODE_ID): cv.int_range(min=0, max=7),
+                cv.Optional(
+                    CONF_SLOT_SPACING, default="1200us"
+                ): cv.All(
+                    cv.positive_time_period_microseconds,
+                    cv.Range(
+                        min=cv.TimePeriod(microseconds=600),
+                        max=cv.TimePeriod(microseconds=5000),
+                    ),
+                ),
+            }
+        ),
+        cv.Optional(CONF_BUS_TIMEOUT_CYCLES, default=3): cv.int_range(
+            min=1, max=20
+        ),
+        cv.Optional(CONF_DISCOVERY): cv.Schema(
+            {
+                cv.Required(CONF_CODES): cv.All(
+                    cv.ensure_list(cv.hex_uint16_t), cv.Length(min=1, max=8)
+                ),
+                cv.Optional(
+                    CONF_WINDOW, default="3s"
+                ): cv.positive_time_period_milliseconds,
+            }
+        ),
+        cv.Optional(CONF_RX_TASK_STACK_SIZE, default=4096): cv.int_range(
+            min=2048, max=16384
+        ),
+        cv.Optional(CONF_TX_QUEUE_SIZE, default=16): cv.one_of(
+            8, 16, 32, 64, int=True
+        ),
+        cv.Optional(CONF_HEAP_AUDIT, default=False): cv.boolean,
+        cv.Optional(CONF_RX_DMA, default=False): cv.boolean,
+        cv.Optional(CONF_CYCLE_LEARNER, default=False): cv.boolean,
+        # DE/RE of the transceiver on the UART's RTS output
+        cv.Optional(CONF_RS485): cv.Schema(
+            {
+                cv.Required(CONF_DE_PIN): pins.internal_gpio_output_pin_number,
+                cv.Optional(CONF_MAX_RETRIES, default=3): cv.int_range(
+                    min=0, max=10
+                ),
+            }
+        ),
+        cv.Optional(CONF_FRAME_STREAM): cv.Schema(
+            {cv.Optional(CONF_PORT, default=6638): cv.port}
+        ),
+        # Needs a data partition in a custom partitions.csv (README)
+        cv.Optional(CONF_JOURNAL): cv.Schema(
+            {
+                cv.Optional(CONF_PARTITION, default="sauna_journal"): cv.All(
+                    cv.string_strict, cv.Length(min=1, max=16)
+                ),
+            }
+        ),
+        # Needs a data partition too; one capture slot takes
+        # (records + 1) * 32 bytes, rounded up to 4 KiB
+        cv.Optional(CONF_FLIGHT_RECORDER): cv.Schema(
+            {
+                cv.Optional(CONF_PARTITION, default="sauna_recorder"): cv.All(
+                    cv.string_strict, cv.Length(min=1, max=16)
+                ),
+                cv.Optional(CONF_RECORDS, default=2048): cv.one_of(
+                    256, 512, 1024, 2048, 4096, 8192, 16384, int=True
+                ),
+                cv.Optional(CONF_PRE_TRIGGER, default="30s"): cv.All(
+                    cv.positive_time_period_milliseconds,
+                    cv.Range(max=cv.TimePeriod(minutes=10)),
+                ),
+                cv.Optional(CONF_POST_TRIGGER, default="10s"): cv.All(
+                    cv.positive_time_period_milliseconds,
+                    cv.Range(max=cv.TimePeriod(minutes=10)),
+                ),
+                cv.Optional(CONF_TRIGGERS, default={}): cv.Schema(
+                    {
+                        cv.Optional(CONF_CODES, default=[]): cv.All(
+                            cv.ensure_list(cv.hex_uint16_t), cv.Length(max=8)
+                        ),
+                        # 0 disables the CRC burst trigger
+                        cv.Optional(CONF_CRC_ERRORS, default=5): cv.int_range(
+                            min=0, max=16
+                        ),
+                        cv.Optional(
+                            CONF_CRC_WINDOW, default="10s"
+                        ): cv.positive_time_period_milliseconds,
+                        cv.Optional(CONF_HEATER_STATE, default=True): cv.boolean,
+                    }
+                ),
+            }
+        ),
+        cv.Optional(CONF_POWER_SAVE): cv.Schema(
+            {
+                # The UART is clocked from APB: nothing below 80 MHz
+                cv.Optional(CONF_MIN_CPU_FREQUENCY, default="80MHz"): cv.All(
+                    cv.frequency, cv.one_of(80e6, 160e6)
+                ),
+                cv.Optional(CONF_LIGHT_SLEEP, default=False): cv.boolean,
+                # After the last byte of a burst, before sleeping
+                cv.Optional(CONF_QUIET_TIME, default="100ms"): cv.All(
+                    cv.positive_time_period_milliseconds,
+                    cv.Range(
+                        min=cv.TimePeriod(milliseconds=60),
+                        max=cv.TimePeriod(seconds=5),
+                    ),
+                ),
+            }
+        ),
+        cv.Optional(CONF_PROFILES): cv.All(
+            cv.ensure_list(PROFILE_SCHEMA), _validate_profiles
+        ),
+    }
+).extend(cv.COMPONENT_SCHEMA)
+
+_UART_SCHEMA = _BASE_SCHEMA.extend(uart.UART_DEVICE_SCHEMA)
+_HOST_SCHEMA = _BASE_SCHEMA.extend(
+    {
+        # Serial device or PTY, e.g. one end of a socat pair
+        cv.Required(CONF_DEVICE): cv.string_strict,
+    }
 )
 
-FINAL_VALIDATE_SCHEMA = uart.final_validate_device_schema(
+
+def _bus_schema(config):
+    if CORE.is_host:
+        return _HOST_SCHEMA(config)
+    return _UART_SCHEMA(config)
+
+
+CONFIG_SCHEMA = cv.All(
+    _bus_schema,
+    _validate_host,
+    _validate_rx_dma,
+    _validate_profile_models,
+    _validate_detection,
+    _validate_virtual_panel,
+)
+
+_UART_FINAL_VALIDATE = uart.final_validate_device_schema(
     "sauna360_uart",
     require_tx=True,
     require_rx=True,
@@ -42,8 +527,268 @@ FINAL_VALIDATE_SCHEMA = uart.final_validate_device_schema(
 )
 
 
+def FINAL_VALIDATE_SCHEMA(config):
+    _validate_custom_total(config)
+    if CORE.is_host:
+        return config
+    return _UART_FINAL_VALIDATE(config)
+
+
+def _log_compiled_out(model):
+    features = MODEL_FEATURES[model]
+    for feature, code in FEATURE_CODE.items():
+        if feature in features:
+            continue
+        entities = ", ".join(sorted(_FEATURE_ENTITIES.get(feature, [])))
+        _LOGGER.info(
+            "sauna360: %s: compiled out %s%s",
+            feature,
+            code,
+            f"; entities not available: {entities}" if entities else "",
+        )
+
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
-    await uart.register_uart_device(var, config)
-    cg.add(var.set_mode(config[CONF_MODEL]))
+    if CORE.is_host:
+        cg.add(var.set_bus_device(config[CONF_DEVICE]))
+    else:
+        await uart.register_uart_device(var, config)
+    # Masks, IFG and supported registers become compile-time constants;
+    # compare ESPHome's flash/RAM summary between models for the savings.
+    model = MODEL_OPTIONS[config[CONF_MODEL]]
+    cg.add_define(f"SAUNA360_MODEL_{model}")
+    _LOGGER.info("sauna360: compiling for model %s", model)
+    _log_compiled_out(config[CONF_MODEL])
+    if CONF_DETECTION_CYCLES in config:
+        cg.add(var.set_detection_cycles(config[CONF_DETECTION_CYCLES]))
+    cg.add(var.set_adaptive_ifg(config[CONF_ADAPTIVE_IFG]))
+    cg.add(var.set_virtual_panel(config[CONF_VIRTUAL_PANEL]))
+    if anomaly := config.get(CONF_ANOMALY_DETECTION):
+        cg.add(
+            var.set_anomaly_detection(
+                anomaly[CONF_STUCK_TIME], anomaly[CONF_MIN_COIL_PERIOD]
+            )
+        )
+    if arbitration := config.get(CONF_ARBITRATION):
+        cg.add(
+            var.set_arbitration(
+                arbitration[CONF_NODE_ID], arbitration[CONF_SLOT_SPACING]
+            )
+        )
+    cg.add(var.set_bus_timeout_cycles(config[CONF_BUS_TIMEOUT_CYCLES]))
+    cg.add_define("SAUNA360_RX_STACK_SIZE", config[CONF_RX_TASK_STACK_SIZE])
+    cg.add_define("SAUNA360_TX_QUEUE_LEN", config[CONF_TX_QUEUE_SIZE])
+    if config[CONF_HEAP_AUDIT]:
+        cg.add_define("SAUNA360_HEAP_AUDIT")
+    if config[CONF_RX_DMA]:
+        cg.add_define("SAUNA360_RX_DMA")
+    if config[CONF_CYCLE_LEARNER]:
+        cg.add_define("SAUNA360_CYCLE_LEARNER")
+
+    if rs485 := config.get(CONF_RS485):
+        cg.add_define("SAUNA360_RS485")
+        cg.add(var.set_rs485(rs485[CONF_DE_PIN], rs485[CONF_MAX_RETRIES]))
+
+    if frame_stream := config.get(CONF_FRAME_STREAM):
+        cg.add_define("SAUNA360_FRAME_STREAM")
+        cg.add(var.set_frame_stream_port(frame_stream[CONF_PORT]))
+
+    if journal := config.get(CONF_JOURNAL):
+        cg.add_define("SAUNA360_JOURNAL")
+        cg.add(var.set_journal_partition(journal[CONF_PARTITION]))
+
+    if recorder := config.get(CONF_FLIGHT_RECORDER):
+        cg.add_define("SAUNA360_FLIGHT_RECORDER")
+        cg.add(
+            var.set_flight_recorder(
+                recorder[CONF_PARTITION],
+                recorder[CONF_RECORDS],
+                recorder[CONF_PRE_TRIGGER],
+                recorder[CONF_POST_TRIGGER],
+            )
+        )
+        triggers = recorder[CONF_TRIGGERS]
+        for code in triggers[CONF_CODES]:
+            cg.add(var.add_recorder_code(code))
+        cg.add(
+            var.set_recorder_crc_burst(
+                triggers[CONF_CRC_ERRORS], triggers[CONF_CRC_WINDOW]
+            )
+        )
+        cg.add(var.set_recorder_heater_state(triggers[CONF_HEATER_STATE]))
+
+    if power_save := config.get(CONF_POWER_SAVE):
+        add_idf_sdkconfig_option("CONFIG_PM_ENABLE", True)
+        if power_save[CONF_LIGHT_SLEEP]:
+            add_idf_sdkconfig_option("CONFIG_FREERTOS_USE_TICKLESS_IDLE", True)
+            add_idf_sdkconfig_option("CONFIG_PM_LIGHT_SLEEP_CALLBACKS", True)
+        cg.add(
+            var.set_power_save(
+                int(power_save[CONF_MIN_CPU_FREQUENCY] / 1e6),
+                power_save[CONF_LIGHT_SLEEP],
+                power_save[CONF_QUIET_TIME],
+            )
+        )
+
+    if discovery := config.get(CONF_DISCOVERY):
+        for code in discovery[CONF_CODES]:
+            cg.add(var.add_discovery_code(code))
+        cg.add(var.set_discovery_window(discovery[CONF_WINDOW]))
+
+    nan = cg.RawExpression("NAN")
+    for profile in config.get(CONF_PROFILES, []):
+        heater = -1
+        if CONF_HEATER in profile:
+            heater = 1 if profile[CONF_HEATER] else 0
+        cg.add(
+            var.add_profile(
+                profile[CONF_NAME],
+                profile.get(CONF_BATH_TEMPERATURE, nan),
+                profile.get(CONF_BATH_TIME, nan),
+                profile.get(CONF_MAX_BATH_TEMPERATURE, nan),
+                profile.get(CONF_HUMIDITY_STEP, nan),
+                profile.get(CONF_HUMIDITY_PERCENT, nan),
+                heater,
+            )
+        )
+
+
+@automation.register_action(
+    "sauna360.apply_profile",
+    ApplyProfileAction,
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.use_id(SAUNA360Component),
+            cv.Required(CONF_PROFILE): cv.templatable(cv.string),
+        }
+    ),
+)
+async def apply_profile_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    templ = await cg.templatable(config[CONF_PROFILE], args, cg.std_string)
+    cg.add(var.set_profile(templ))
+    return var
+
+
+@automation.register_action(
+    "sauna360.dump_registers",
+    DumpRegistersAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(SAUNA360Component)}),
+)
+async def dump_registers_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+@automation.register_action(
+    "sauna360.discovery_report",
+    DiscoveryReportAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(SAUNA360Component)}),
+)
+async def discovery_report_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+@automation.register_action(
+    "sauna360.reset_latency",
+    ResetLatencyAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(SAUNA360Component)}),
+)
+async def reset_latency_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+@automation.register_action(
+    "sauna360.journal_dump",
+    JournalDumpAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(SAUNA360Component)}),
+)
+async def journal_dump_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+@automation.register_action(
+    "sauna360.journal_clear",
+    JournalClearAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(SAUNA360Component)}),
+)
+async def journal_clear_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+@automation.register_action(
+    "sauna360.recorder_dump",
+    RecorderDumpAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(SAUNA360Component)}),
+)
+async def recorder_dump_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+@automation.register_action(
+    "sauna360.recorder_trigger",
+    RecorderTriggerAction,
+    cv.Schema({cv.GenerateID(): cv.use_id(SAUNA360Component)}),
+)
+async def recorder_trigger_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+def _validate_benchmark(config):
+    if config[CONF_MAX_RATE] < config[CONF_START_RATE]:
+        raise cv.Invalid(
+            f"'{CONF_MAX_RATE}' must not be below '{CONF_START_RATE}'",
+            path=[CONF_MAX_RATE],
+        )
+    return config
+
+
+@automation.register_action(
+    "sauna360.benchmark",
+    BenchmarkAction,
+    cv.All(
+        cv.Schema(
+            {
+                cv.GenerateID(): cv.use_id(SAUNA360Component),
+                cv.Optional(CONF_START_RATE, default=50): cv.int_range(
+                    min=1, max=100000
+                ),
+                cv.Optional(CONF_MAX_RATE, default=12800): cv.int_range(
+                    min=1, max=100000
+                ),
+                cv.Optional(CONF_STEP_DURATION, default="2s"): cv.All(
+                    cv.positive_time_period_milliseconds,
+                    cv.Range(
+                        min=cv.TimePeriod(milliseconds=500),
+                        max=cv.TimePeriod(seconds=10),
+                    ),
+                ),
+            }
+        ),
+        _validate_benchmark,
+    ),
+)
+async def benchmark_to_code(config, action_id, template_arg, args):
+    # The benchmark is only compiled in when an automation uses it
+    cg.add_define("SAUNA360_BENCHMARK")
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    cg.add(var.set_rates(config[CONF_START_RATE], config[CONF_MAX_RATE]))
+    cg.add(var.set_step_duration(config[CONF_STEP_DURATION]))
+    return var
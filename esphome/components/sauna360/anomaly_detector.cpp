@@ -0,0 +1,193 @@
+#include "anomaly_detector.h"
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace sauna360 {
+
+const char *AnomalyDetector::reason_name(Reason reason) {
+  switch (reason) {
+  case REASON_STUCK_TEMPERATURE:
+    return "stuck_temperature";
+  case REASON_HEATING_RATE:
+    return "heating_rate";
+  case REASON_COIL_CYCLING:
+    return "coil_cycling";
+  case REASON_SETPOINT_MISMATCH:
+    return "setpoint_mismatch";
+  default:
+    return "none";
+  }
+}
+
+void AnomalyDetector::raise_(Reason reason, const char *fmt, ...) {
+  if (this->pending_[reason])
+    return; // loop has not picked up the previous one yet
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(this->detail_[reason], DETAIL_MAX, fmt, args);
+  va_end(args);
+  this->pending_[reason] = true;
+}
+
+bool AnomalyDetector::poll(Reason *reason, char *detail, size_t detail_len) {
+  for (uint8_t r = REASON_STUCK_TEMPERATURE; r <= REASON_SETPOINT_MISMATCH;
+       r++) {
+    if (!this->pending_[r])
+      continue;
+    *reason = static_cast<Reason>(r);
+    snprintf(detail, detail_len, "%s", this->detail_[r]);
+    this->pending_[r] = false;
+    return true;
+  }
+  return false;
+}
+
+void AnomalyDetector::reset() {
+  this->have_temp_ = false;
+  this->coils_ = 0;
+  this->stuck_latched_ = false;
+  this->rate_window_open_ = false;
+  this->rate_outliers_ = 0;
+  this->rate_latched_ = false;
+  this->coil_on_seen_ = false;
+  this->fast_cycles_ = 0;
+  this->cycling_latched_ = false;
+}
+
+void AnomalyDetector::on_temperature(uint16_t raw, uint32_t now_ms) {
+  this->temp_raw_ = raw;
+  if (!this->have_temp_) {
+    this->have_temp_ = true;
+    this->stuck_ref_raw_ = raw;
+    this->stuck_ref_ms_ = now_ms;
+    return;
+  }
+
+  // Stuck: coils on, well below setpoint, temperature not moving
+  const bool heating = this->coils_ != 0 &&
+                       raw + BELOW_SETPOINT_RAW < this->setpoint_raw_;
+  const uint16_t moved = raw > this->stuck_ref_raw_
+                             ? raw - this->stuck_ref_raw_
+                             : this->stuck_ref_raw_ - raw;
+  if (!heating || moved >= STUCK_DELTA_RAW) {
+    this->stuck_ref_raw_ = raw;
+    this->stuck_ref_ms_ = now_ms;
+    this->stuck_latched_ = false;
+  } else if (!this->stuck_latched_ &&
+             now_ms - this->stuck_ref_ms_ >= this->stuck_ms_) {
+    this->stuck_latched_ = true;
+    this->raise_(REASON_STUCK_TEMPERATURE,
+                 "%.1f C for %u min with %u coil(s) on", raw / 9.0f,
+                 (unsigned)((now_ms - this->stuck_ref_ms_) / 60000),
+                 (unsigned)this->coils_);
+  }
+
+  this->check_rate_(now_ms);
+}
+
+void AnomalyDetector::check_rate_(uint32_t now_ms) {
+  // Only the heat-up ramp is comparable between sessions
+  const bool ramp = this->coils_ != 0 && this->temp_raw_ +
+                                                 RAMP_BELOW_SETPOINT_RAW <
+                                             this->setpoint_raw_;
+  if (!ramp) {
+    this->rate_window_open_ = false;
+    return;
+  }
+  if (!this->rate_window_open_) {
+    this->rate_window_open_ = true;
+    this->rate_ref_raw_ = this->temp_raw_;
+    this->rate_ref_ms_ = now_ms;
+    return;
+  }
+  const uint32_t elapsed = now_ms - this->rate_ref_ms_;
+  if (elapsed < RATE_WINDOW_MS)
+    return;
+
+  const float rate = (static_cast<int>(this->temp_raw_) -
+                      static_cast<int>(this->rate_ref_raw_)) /
+                     9.0f / (elapsed / 60000.0f);
+  this->rate_ref_raw_ = this->temp_raw_;
+  this->rate_ref_ms_ = now_ms;
+
+  bool outlier = false;
+  if (this->rate_n_ >= RATE_MIN_SAMPLES) {
+    const float sd = std::sqrt(this->rate_m2_ / (this->rate_n_ - 1));
+    const float limit = std::fmax(RATE_SIGMAS * sd, RATE_MIN_DEVIATION);
+    outlier = std::fabs(rate - this->rate_mean_) > limit;
+    if (outlier) {
+      if (this->rate_outliers_ < 0xFF)
+        this->rate_outliers_++;
+      if (!this->rate_latched_ &&
+          this->rate_outliers_ >= RATE_CONFIRM_WINDOWS) {
+        this->rate_latched_ = true;
+        this->raise_(REASON_HEATING_RATE, "%.2f C/min, expected %.2f +/- %.2f",
+                     rate, this->rate_mean_, limit);
+      }
+      return; // do not learn from faults
+    }
+  }
+  this->rate_outliers_ = 0;
+  this->rate_latched_ = false;
+
+  // Welford update
+  this->rate_n_++;
+  const float delta = rate - this->rate_mean_;
+  this->rate_mean_ += delta / this->rate_n_;
+  this->rate_m2_ += delta * (rate - this->rate_mean_);
+}
+
+void AnomalyDetector::on_setpoint(uint16_t raw, uint32_t now_ms) {
+  this->setpoint_raw_ = raw;
+  if (!this->setpoint_pending_)
+    return;
+  const int reported = raw / 9;
+  if (reported == this->setpoint_cmd_) {
+    this->setpoint_pending_ = false;
+  } else if (now_ms - this->setpoint_cmd_ms_ >= SETPOINT_GRACE_MS) {
+    // Report once; the heater's value is the truth from here on
+    this->setpoint_pending_ = false;
+    this->raise_(REASON_SETPOINT_MISMATCH, "sent %d C, heater reports %d C",
+                 this->setpoint_cmd_, reported);
+  }
+}
+
+void AnomalyDetector::on_setpoint_command(int celsius, uint32_t now_ms) {
+  this->setpoint_cmd_ = celsius;
+  this->setpoint_cmd_ms_ = now_ms;
+  this->setpoint_pending_ = true;
+}
+
+void AnomalyDetector::on_coils(uint8_t active, uint32_t now_ms) {
+  const bool was_on = this->coils_ != 0;
+  this->coils_ = active;
+  if (active == 0 || was_on)
+    return;
+
+  // Rising edge: period since the previous switch-on
+  if (this->coil_on_seen_) {
+    const uint32_t period = now_ms - this->last_coil_on_ms_;
+    if (period < this->min_coil_period_ms_) {
+      if (this->fast_cycles_ < 0xFF)
+        this->fast_cycles_++;
+      if (!this->cycling_latched_ && this->fast_cycles_ >= CYCLING_CONFIRM) {
+        this->cycling_latched_ = true;
+        this->raise_(REASON_COIL_CYCLING, "switched on every %u s (min %u s)",
+                     (unsigned)(period / 1000),
+                     (unsigned)(this->min_coil_period_ms_ / 1000));
+      }
+    } else {
+      this->fast_cycles_ = 0;
+      this->cycling_latched_ = false;
+    }
+  }
+  this->coil_on_seen_ = true;
+  this->last_coil_on_ms_ = now_ms;
+}
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sauna360 {
+
+// Streaming plausibility checks on the decoded heater values, meant to flag
+// a failing sensor, contactor or heater before the heater's own lockout.
+// Constant memory: a handful of scalars per detector, no history.
+//
+// Fed from the RX task as frames are decoded; events are latched and
+// collected by loop() through poll(). Each detector fires once when its
+// condition starts and re-arms when the condition clears.
+class AnomalyDetector {
+public:
+  enum Reason : uint8_t {
+    REASON_NONE = 0,
+    // Coils energised, temperature below setpoint, no change for stuck_ms
+    REASON_STUCK_TEMPERATURE = 1,
+    // Heat-up rate outside the envelope learned from earlier sessions
+    REASON_HEATING_RATE = 2,
+    // Coils switching on again sooner than min_coil_period_ms
+    REASON_COIL_CYCLING = 3,
+    // Heater setpoint does not follow the value we sent
+    REASON_SETPOINT_MISMATCH = 4,
+  };
+  static const char *reason_name(Reason reason);
+
+  static constexpr uint16_t STUCK_DELTA_RAW = 9;     // 1 C, raw is C * 9
+  static constexpr uint16_t BELOW_SETPOINT_RAW = 18; // 2 C
+  static constexpr uint16_t RAMP_BELOW_SETPOINT_RAW = 45; // 5 C
+  static constexpr uint32_t RATE_WINDOW_MS = 60000;
+  static constexpr uint32_t RATE_MIN_SAMPLES = 30;
+  static constexpr float RATE_SIGMAS = 4.0f;
+  static constexpr float RATE_MIN_DEVIATION = 0.5f; // C / min
+  static constexpr uint8_t RATE_CONFIRM_WINDOWS = 3;
+  static constexpr uint8_t CYCLING_CONFIRM = 3;
+  static constexpr uint32_t SETPOINT_GRACE_MS = 30000;
+  static constexpr size_t DETAIL_MAX = 64;
+
+  void set_stuck_ms(uint32_t ms) { this->stuck_ms_ = ms; }
+  void set_min_coil_period_ms(uint32_t ms) { this->min_coil_period_ms_ = ms; }
+
+  // RX task, per decoded frame
+  void on_temperature(uint16_t raw, uint32_t now_ms);
+  void on_setpoint(uint16_t raw, uint32_t now_ms);
+  void on_coils(uint8_t active, uint32_t now_ms);
+  // Main loop, when we send a new setpoint (C)
+  void on_setpoint_command(int celsius, uint32_t now_ms);
+  // Bus lost: forget the running state, keep the learned envelope
+  void reset();
+
+  // Main loop. Copies the oldest unreported event; false if there is none.
+  bool poll(Reason *reason, char *detail, size_t detail_len);
+
+  float rate_mean() const { return this->rate_mean_; }
+  uint32_t rate_samples() const { return this->rate_n_; }
+
+protected:
+  void raise_(Reason reason, const char *fmt, ...);
+  void check_rate_(uint32_t now_ms);
+
+  uint32_t stuck_ms_{10 * 60 * 1000};
+  uint32_t min_coil_period_ms_{60 * 1000};
+
+  bool have_temp_{false};
+  uint16_t temp_raw_{0};
+  uint16_t setpoint_raw_{0};
+  uint8_t coils_{0};
+
+  // Stuck temperature
+  uint16_t stuck_ref_raw_{0};
+  uint32_t stuck_ref_ms_{0};
+  bool stuck_latched_{false};
+
+  // Heating rate: Welford mean / variance of C per minute
+  uint16_t rate_ref_raw_{0};
+  uint32_t rate_ref_ms_{0};
+  bool rate_window_open_{false};
+  uint32_t rate_n_{0};
+  float rate_mean_{0};
+  float rate_m2_{0};
+  uint8_t rate_outliers_{0};
+  bool rate_latched_{false};
+
+  // Coil cycling
+  uint32_t last_coil_on_ms_{0};
+  bool coil_on_seen_{false};
+  uint8_t fast_cycles_{0};
+  bool cycling_latched_{false};
+
+  // Setpoint follow-up
+  bool setpoint_pending_{false};
+  int setpoint_cmd_{0};
+  uint32_t setpoint_cmd_ms_{0};
+
+  // One pending event per reason; RX task sets, loop clears
+  volatile bool pending_[5]{};
+  char detail_[5][DETAIL_MAX]{};
+};
+
+} // namespace sauna360
+} // namespace esphome
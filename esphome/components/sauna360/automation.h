@@ -0,0 +1,93 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "sauna360.h"
+
+namespace esphome {
+namespace sauna360 {
+
+template <typename... Ts>
+class ApplyProfileAction : public Action<Ts...>,
+                           public Parented<SAUNA360Component> {
+public:
+  TEMPLATABLE_VALUE(std::string, profile)
+
+  void play(const Ts &...x) override {
+    this->parent_->apply_profile(this->profile_.value(x...));
+  }
+};
+
+template <typename... Ts>
+class DumpRegistersAction : public Action<Ts...>,
+                            public Parented<SAUNA360Component> {
+public:
+  void play(const Ts &...x) override { this->parent_->dump_registers(); }
+};
+
+template <typename... Ts>
+class DiscoveryReportAction : public Action<Ts...>,
+                              public Parented<SAUNA360Component> {
+public:
+  void play(const Ts &...x) override { this->parent_->discovery_report(); }
+};
+
+template <typename... Ts>
+class ResetLatencyAction : public Action<Ts...>,
+                           public Parented<SAUNA360Component> {
+public:
+  void play(const Ts &...x) override { this->parent_->reset_latency(); }
+};
+
+template <typename... Ts>
+class JournalDumpAction : public Action<Ts...>,
+                          public Parented<SAUNA360Component> {
+public:
+  void play(const Ts &...x) override { this->parent_->journal_dump(); }
+};
+
+template <typename... Ts>
+class JournalClearAction : public Action<Ts...>,
+                           public Parented<SAUNA360Component> {
+public:
+  void play(const Ts &...x) override { this->parent_->journal_clear(); }
+};
+
+template <typename... Ts>
+class RecorderDumpAction : public Action<Ts...>,
+                           public Parented<SAUNA360Component> {
+public:
+  void play(const Ts &...x) override { this->parent_->recorder_dump(); }
+};
+
+template <typename... Ts>
+class RecorderTriggerAction : public Action<Ts...>,
+                              public Parented<SAUNA360Component> {
+public:
+  void play(const Ts &...x) override { this->parent_->recorder_trigger(); }
+};
+
+#ifdef SAUNA360_BENCHMARK
+template <typename... Ts>
+class BenchmarkAction : public Action<Ts...>,
+                        public Parented<SAUNA360Component> {
+public:
+  void set_rates(uint32_t start_rate, uint32_t max_rate) {
+    this->start_rate_ = start_rate;
+    this->max_rate_ = max_rate;
+  }
+  void set_step_duration(uint32_t ms) { this->step_ms_ = ms; }
+
+  void play(const Ts &...x) override {
+    this->parent_->benchmark(this->start_rate_, this->max_rate_,
+                             this->step_ms_);
+  }
+
+protected:
+  uint32_t start_rate_{50};
+  uint32_t max_rate_{12800};
+  uint32_t step_ms_{2000};
+};
+#endif
+
+} // namespace sauna360
+} // namespace esphome
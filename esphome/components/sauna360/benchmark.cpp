@@ -0,0 +1,184 @@
+#include "benchmark.h"
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace sauna360 {
+
+// One burst per millisecond, then the RX task sleeps for a tick
+static constexpr uint32_t BURST_PERIOD_MS = 1;
+static constexpr uint32_t BURST_BUDGET_US =
+    BURST_PERIOD_MS * 1000u * Benchmark::BURST_BUDGET_PERCENT / 100u;
+
+bool Benchmark::add_frame(uint8_t type, uint16_t code, uint32_t data) {
+  if (this->frame_count_ >= MAX_FRAMES)
+    return false;
+  Frame &f = this->frames_[this->frame_count_++];
+  f.len =
+      static_cast<uint8_t>(protocol::encode_frame(type, code, data, f.data));
+  return true;
+}
+
+bool Benchmark::request(uint32_t start_rate, uint32_t max_rate,
+                        uint32_t step_ms) {
+  if (this->running() || this->frame_count_ == 0 || start_rate == 0)
+    return false;
+  this->step_ms_ = step_ms;
+  this->steps_planned_ = 0;
+  this->steps_[this->steps_planned_++] = Step{}; // baseline
+  for (uint32_t rate = start_rate;
+       rate <= max_rate && this->steps_planned_ < MAX_STEPS; rate *= 2) {
+    Step step;
+    step.rate = rate;
+    this->steps_[this->steps_planned_++] = step;
+  }
+  this->steps_run_ = 0;
+  this->current_step_ = 0;
+  this->next_frame_ = 0;
+  this->last_loop_us_ = 0;
+  this->state_ = PENDING;
+  return true;
+}
+
+void Benchmark::on_loop(uint32_t now_us) {
+  if (this->state_ != RUNNING) {
+    this->last_loop_us_ = 0;
+    return;
+  }
+  if (this->last_loop_us_ != 0) {
+    Step &step = this->steps_[this->current_step_];
+    const uint32_t interval = now_us - this->last_loop_us_;
+    step.loop_count++;
+    step.loop_sum_us += interval;
+    if (interval > step.loop_max_us)
+      step.loop_max_us = interval;
+  }
+  this->last_loop_us_ = now_us;
+}
+
+bool Benchmark::take_result() {
+  if (this->state_ != DONE)
+    return false;
+  this->state_ = IDLE;
+  return true;
+}
+
+void Benchmark::run(InjectFn inject, void *ctx) {
+  this->state_ = RUNNING;
+  for (uint8_t i = 0; i < this->steps_planned_; i++) {
+    this->current_step_ = i;
+    this->run_step_(this->steps_[i], inject, ctx);
+    this->steps_run_ = i + 1;
+    if (!this->steps_[i].sustained)
+      break;
+  }
+  this->state_ = DONE;
+}
+
+void Benchmark::run_step_(Step &step, InjectFn inject, void *ctx) {
+  uint32_t backlog_limit = step.rate * BACKLOG_MS / 1000u;
+  if (backlog_limit == 0)
+    backlog_limit = 1;
+  const uint32_t step_us = this->step_ms_ * 1000u;
+  const uint32_t start_us = micros();
+  step.sustained = true;
+  for (;;) {
+    const uint32_t elapsed = micros() - start_us;
+    if (elapsed >= step_us)
+      break;
+    const uint32_t due = static_cast<uint32_t>(
+        static_cast<uint64_t>(step.rate) * elapsed / 1000000u);
+    const uint32_t burst_us = micros();
+    while (step.frames < due && (micros() - burst_us) < BURST_BUDGET_US) {
+      const Frame &f = this->frames_[this->next_frame_];
+      this->next_frame_ = (this->next_frame_ + 1) % this->frame_count_;
+      const uint32_t c0 = arch_get_cpu_cycle_count();
+      inject(ctx, f.data, f.len);
+      const uint32_t cycles = arch_get_cpu_cycle_count() - c0;
+      step.cycles += cycles;
+      if (cycles > step.cycles_max)
+        step.cycles_max = cycles;
+      step.frames++;
+    }
+    const uint32_t backlog = due - step.frames;
+    if (backlog > step.backlog_max)
+      step.backlog_max = backlog;
+    if (backlog > backlog_limit) {
+      step.sustained = false;
+      break;
+    }
+    delay(BURST_PERIOD_MS);
+  }
+}
+
+uint32_t Benchmark::cycles_per_frame() const {
+  uint64_t cycles = 0;
+  uint32_t frames = 0;
+  for (uint8_t i = 1; i < this->steps_run_; i++) {
+    cycles += this->steps_[i].cycles;
+    frames += this->steps_[i].frames;
+  }
+  return frames != 0 ? static_cast<uint32_t>(cycles / frames) : 0;
+}
+
+uint32_t Benchmark::cycles_max() const {
+  uint32_t max = 0;
+  for (uint8_t i = 1; i < this->steps_run_; i++) {
+    if (this->steps_[i].cycles_max > max)
+      max = this->steps_[i].cycles_max;
+  }
+  return max;
+}
+
+// Last sustained step, or the last step that ran if none was
+uint8_t Benchmark::best_step_() const {
+  uint8_t best = this->steps_run_ > 0 ? this->steps_run_ - 1 : 0;
+  for (uint8_t i = 1; i < this->steps_run_; i++) {
+    if (this->steps_[i].sustained)
+      best = i;
+  }
+  return best;
+}
+
+uint32_t Benchmark::max_rate() const {
+  const Step &step = this->steps_[this->best_step_()];
+  return step.sustained ? step.rate : 0;
+}
+
+uint32_t Benchmark::loop_jitter_us() const {
+  if (this->steps_run_ < 2)
+    return 0;
+  const uint32_t base = this->steps_[0].loop_avg_us();
+  const uint32_t worst = this->steps_[this->best_step_()].loop_max_us;
+  return worst > base ? worst - base : 0;
+}
+
+void Benchmark::log_result(const char *tag) const {
+  const uint32_t mhz = arch_get_cpu_freq_hz() / 1000000u;
+  const uint32_t cpf = this->cycles_per_frame();
+  ESP_LOGI(tag,
+           "Benchmark: %u frame types, %u cycles/frame (%u us at %u MHz)",
+           (unsigned)this->frame_count_, (unsigned)cpf,
+           (unsigned)(mhz != 0 ? cpf / mhz : 0), (unsigned)mhz);
+  for (uint8_t i = 0; i < this->steps_run_; i++) {
+    const Step &s = this->steps_[i];
+    if (i == 0) {
+      ESP_LOGI(tag, "  baseline: loop avg %u us, max %u us",
+               (unsigned)s.loop_avg_us(), (unsigned)s.loop_max_us);
+      continue;
+    }
+    ESP_LOGI(tag,
+             "  %5u/s: %s, %u frames, cycles avg %u max %u, backlog %u, "
+             "loop avg %u us, max %u us",
+             (unsigned)s.rate, s.sustained ? "ok" : "behind",
+             (unsigned)s.frames, (unsigned)s.cycles_avg(),
+             (unsigned)s.cycles_max, (unsigned)s.backlog_max,
+             (unsigned)s.loop_avg_us(), (unsigned)s.loop_max_us);
+  }
+  ESP_LOGI(tag, "Benchmark: max sustained %u frames/s, loop jitter %u us",
+           (unsigned)this->max_rate(), (unsigned)this->loop_jitter_us());
+}
+
+} // namespace sauna360
+} // namespace esphome
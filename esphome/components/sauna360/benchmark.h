@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sauna360_protocol.h"
+
+namespace esphome {
+namespace sauna360 {
+
+// On-target decode benchmark (sauna360.benchmark action).
+//
+// Runs on the RX task in place of the bus: the UART is not read while it
+// runs, and heater frames are fed through the normal byte path at a rate
+// that doubles every step, after one idle step for the main loop baseline.
+// The frames due are injected in one burst per millisecond that may use
+// BURST_BUDGET_PERCENT of it, much like a UART FIFO handing over bytes. A
+// step is sustained while the backlog of frames due but not yet injected
+// stays under BACKLOG_MS worth of traffic; the first step that falls behind
+// ends the run. The main loop samples its own interval meanwhile, so the
+// load the RX side puts on it shows up as loop jitter.
+//
+// request() and on_loop() run on the main loop, run() on the RX task.
+class Benchmark {
+public:
+  static constexpr uint8_t MAX_FRAMES = 24;
+  static constexpr uint8_t MAX_STEPS = 10; // including the baseline
+  static constexpr uint8_t BURST_BUDGET_PERCENT = 75;
+  static constexpr uint32_t BACKLOG_MS = 100;
+
+  struct Step {
+    uint32_t rate{0}; // frames/s, 0 = baseline
+    uint32_t frames{0};
+    uint64_t cycles{0};
+    uint32_t cycles_max{0};
+    uint32_t backlog_max{0};
+    bool sustained{false};
+    // Written by the main loop
+    uint32_t loop_count{0};
+    uint64_t loop_sum_us{0};
+    uint32_t loop_max_us{0};
+
+    uint32_t cycles_avg() const {
+      return this->frames != 0 ? static_cast<uint32_t>(this->cycles /
+                                                       this->frames)
+                               : 0;
+    }
+    uint32_t loop_avg_us() const {
+      return this->loop_count != 0
+                 ? static_cast<uint32_t>(this->loop_sum_us / this->loop_count)
+                 : 0;
+    }
+  };
+
+  // Feeds one raw frame (SOF..EOF) through the decode path
+  using InjectFn = void (*)(void *ctx, const uint8_t *frame, size_t len);
+
+  // Frames replayed round-robin; set before request()
+  void clear_frames() { this->frame_count_ = 0; }
+  bool add_frame(uint8_t type, uint16_t code, uint32_t data);
+  uint8_t frame_count() const { return this->frame_count_; }
+
+  // False while a run is in progress
+  bool request(uint32_t start_rate, uint32_t max_rate, uint32_t step_ms);
+  bool pending() const { return this->state_ == PENDING; }
+  bool running() const {
+    return this->state_ == PENDING || this->state_ == RUNNING;
+  }
+  void on_loop(uint32_t now_us);
+  // True once after a run has finished
+  bool take_result();
+
+  void run(InjectFn inject, void *ctx);
+
+  // Steps that ran, baseline first
+  uint8_t step_count() const { return this->steps_run_; }
+  const Step &step(uint8_t i) const { return this->steps_[i]; }
+  // Over all loaded steps
+  uint32_t cycles_per_frame() const;
+  uint32_t cycles_max() const;
+  // Highest sustained rate, frames/s; 0 if even the first step fell behind
+  uint32_t max_rate() const;
+  // Worst loop interval at max_rate() over the baseline average, us
+  uint32_t loop_jitter_us() const;
+  void log_result(const char *tag) const;
+
+protected:
+  enum State : uint8_t { IDLE, PENDING, RUNNING, DONE };
+
+  struct Frame {
+    uint8_t len;
+    uint8_t data[protocol::MAX_FRAME_LEN];
+  };
+
+  void run_step_(Step &step, InjectFn inject, void *ctx);
+  uint8_t best_step_() const;
+
+  Frame frames_[MAX_FRAMES];
+  uint8_t frame_count_{0};
+  uint8_t next_frame_{0};
+
+  uint32_t step_ms_{0};
+  // Planned by request(); run() fills in the RX side, on_loop() the loop
+  // side of the current step
+  Step steps_[MAX_STEPS];
+  uint8_t steps_planned_{0};
+  volatile uint8_t steps_run_{0};
+  volatile uint8_t current_step_{0};
+  volatile State state_{IDLE};
+  uint32_t last_loop_us_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
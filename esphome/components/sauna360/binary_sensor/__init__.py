@@ -3,24 +3,33 @@ import esphome.config_validation as cv
 from esphome.components import binary_sensor
 from esphome.const import (
     CONF_ID,
+    DEVICE_CLASS_CONNECTIVITY,
     DEVICE_CLASS_HEAT,
     DEVICE_CLASS_LIGHT,
     DEVICE_CLASS_SAFETY,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     ICON_LIGHTBULB,
 )
 from .. import (
     sauna360_ns,
     SAUNA360Component,
     CONF_SAUNA360_ID,
+    CONF_CUSTOM,
+    custom_field_schema,
+    register_custom_field,
 )
 
 SAUNA360BinarySensor = sauna360_ns.class_(
     "SAUNA360BinarySensor", binary_sensor.BinarySensor, cg.Component
 )
+SAUNA360CustomBinarySensor = sauna360_ns.class_(
+    "SAUNA360CustomBinarySensor", binary_sensor.BinarySensor
+)
 
 CONF_HEATER_STATUS = "heater_status"
 CONF_LIGHT_STATUS = "light_status"
 CONF_READY_STATUS = "ready_status"
+CONF_BUS_AVAILABLE = "bus_available"
 
 CONFIG_SCHEMA = cv.All(
     cv.COMPONENT_SCHEMA.extend(
@@ -38,6 +47,17 @@ CONFIG_SCHEMA = cv.All(
                 device_class=DEVICE_CLASS_SAFETY,
                 icon="mdi:security",
             ),
+            cv.Optional(CONF_BUS_AVAILABLE): binary_sensor.binary_sensor_schema(
+                device_class=DEVICE_CLASS_CONNECTIVITY,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:serial-port",
+            ),
+            # Non-zero field value = ON
+            cv.Optional(CONF_CUSTOM): custom_field_schema(
+                binary_sensor.binary_sensor_schema(SAUNA360CustomBinarySensor),
+                bit_width=1,
+                scaled=False,
+            ),
         }
     ),
 )
@@ -55,5 +75,12 @@ async def to_code(config):
     if CONF_READY_STATUS in config:
         sens = await binary_sensor.new_binary_sensor(config[CONF_READY_STATUS])
         cg.add(var.set_ready_binary_sensor(sens))
+    if CONF_BUS_AVAILABLE in config:
+        sens = await binary_sensor.new_binary_sensor(config[CONF_BUS_AVAILABLE])
+        cg.add(var.set_bus_binary_sensor(sens))
     sauna360 = await cg.get_variable(config[CONF_SAUNA360_ID])
     cg.add(sauna360.register_listener(var))
+
+    for field in config.get(CONF_CUSTOM, []):
+        sens = await binary_sensor.new_binary_sensor(field)
+        await register_custom_field(sauna360, field, sens)
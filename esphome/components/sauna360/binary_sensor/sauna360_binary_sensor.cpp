@@ -15,6 +15,7 @@ namespace esphome
       LOG_BINARY_SENSOR("  ", "HEATER STATUS", this->heater_bsensor_);
       LOG_BINARY_SENSOR("  ", "LIGHT STATUS", this->light_bsensor_);
       LOG_BINARY_SENSOR("  ", "READY STATUS", this->ready_bsensor_);
+      LOG_BINARY_SENSOR("  ", "BUS AVAILABLE", this->bus_bsensor_);
     }
 
   } // namespace sauna360
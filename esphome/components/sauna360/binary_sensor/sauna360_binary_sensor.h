@@ -17,7 +17,7 @@ namespace esphome
       {
         if (this->heater_bsensor_ != nullptr)
         {
-          if (this->heater_bsensor_->state != heater_status)
+          if (!this->heater_bsensor_->has_state() || this->heater_bsensor_->state != heater_status)
           {
             this->heater_bsensor_->publish_state(heater_status);
           }
@@ -29,7 +29,7 @@ namespace esphome
       {
         if (this->light_bsensor_ != nullptr)
         {
-          if (this->light_bsensor_->state != light_status)
+          if (!this->light_bsensor_->has_state() || this->light_bsensor_->state != light_status)
           {
             this->light_bsensor_->publish_state(light_status);
           }
@@ -41,18 +41,48 @@ namespace esphome
       {
         if (this->ready_bsensor_ != nullptr)
         {
-          if (this->ready_bsensor_->state != ready_status)
+          if (!this->ready_bsensor_->has_state() || this->ready_bsensor_->state != ready_status)
           {
             this->ready_bsensor_->publish_state(ready_status);
           }
         }
       }
 
+      void set_bus_binary_sensor(binary_sensor::BinarySensor *bsensor) { this->bus_bsensor_ = bsensor; };
+      void on_bus_available(bool available) override
+      {
+        if (this->bus_bsensor_ != nullptr)
+        {
+          this->bus_bsensor_->publish_state(available);
+        }
+        if (!available)
+        {
+          for (auto *bsensor : {this->heater_bsensor_, this->light_bsensor_, this->ready_bsensor_})
+          {
+            if (bsensor != nullptr)
+            {
+              bsensor->invalidate_state();
+            }
+          }
+        }
+      }
+
     protected:
       binary_sensor::BinarySensor *heater_bsensor_{nullptr};
       binary_sensor::BinarySensor *light_bsensor_{nullptr};
       binary_sensor::BinarySensor *ready_bsensor_{nullptr};
+      binary_sensor::BinarySensor *bus_bsensor_{nullptr};
+    };
+
+#ifdef SAUNA360_CUSTOM_REGISTERS
+    // `custom:` register field, ON when the field is non-zero
+    class SAUNA360CustomBinarySensor : public binary_sensor::BinarySensor, public CustomFieldSink
+    {
+    public:
+      void on_custom_value(uint32_t raw, float value) override { this->publish_state(raw != 0); }
+      void on_custom_unavailable() override { this->invalidate_state(); }
     };
+#endif
 
   } // namespace sauna360
 } // namespace esphome
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "bit_discovery.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace sauna360 {
+
+static const char *const EVENT_NAMES[BitDiscovery::NUM_EVENTS] = {
+    "heater on", "heater off", "light toggle", "door error",
+    "setpoint change"};
+
+bool BitDiscovery::add_code(uint16_t code) {
+  if (this->num_slots_ >= MAX_CODES)
+    return false;
+  this->slots_[this->num_slots_++].code = code;
+  return true;
+}
+
+void BitDiscovery::on_frame(uint16_t code, uint32_t value, uint32_t now_ms) {
+  for (uint8_t i = 0; i < this->num_slots_; i++) {
+    Slot &slot = this->slots_[i];
+    if (slot.code != code)
+      continue;
+
+    slot.frames++;
+    uint32_t diff = slot.has_value ? (slot.value ^ value) : 0;
+    slot.value = value;
+    slot.has_value = true;
+
+    while (diff != 0) {
+      const uint8_t bit = __builtin_ctz(diff);
+      diff &= diff - 1;
+      inc_(slot.toggles[bit]);
+      slot.last_toggle_ms[bit] = now_ms;
+      // Event first, toggle second
+      for (uint8_t e = 0; e < NUM_EVENTS; e++) {
+        if (this->within_(this->last_event_ms_[e], now_ms))
+          inc_(slot.cooc[e][bit]);
+      }
+    }
+    return;
+  }
+}
+
+void BitDiscovery::on_event(Event event, uint32_t now_ms) {
+  this->last_event_ms_[event] = now_ms;
+  inc_(this->event_count_[event]);
+  // Toggle first, event second
+  for (uint8_t i = 0; i < this->num_slots_; i++) {
+    Slot &slot = this->slots_[i];
+    for (uint8_t bit = 0; bit < 32; bit++) {
+      if (this->within_(slot.last_toggle_ms[bit], now_ms))
+        inc_(slot.cooc[event][bit]);
+    }
+  }
+}
+
+void BitDiscovery::log_report(const char *tag, uint8_t top_n) const {
+  ESP_LOGI(tag, "Bit discovery report (window %u ms)",
+           (unsigned)this->window_ms_);
+  for (uint8_t i = 0; i < this->num_slots_; i++) {
+    const Slot &slot = this->slots_[i];
+    ESP_LOGI(tag, "  %04X: %u frames, last 0x%08X", slot.code,
+             (unsigned)slot.frames, (unsigned)slot.value);
+
+    for (uint8_t e = 0; e < NUM_EVENTS; e++) {
+      const uint16_t events = this->event_count_[e];
+      if (events == 0)
+        continue;
+
+      // Score = precision x recall: share of the bit's toggles that hit the
+      // event times share of events accompanied by a toggle.
+      const uint8_t limit = top_n > 8 ? 8 : top_n;
+      uint8_t best_bit[8];
+      float best_score[8];
+      uint8_t n = 0;
+      for (uint8_t bit = 0; bit < 32; bit++) {
+        const uint16_t hits = slot.cooc[e][bit];
+        if (hits < 2 || slot.toggles[bit] == 0)
+          continue;
+        const float precision =
+            static_cast<float>(hits) / static_cast<float>(slot.toggles[bit]);
+        const float recall =
+            static_cast<float>(hits) / static_cast<float>(events);
+        const float score = (precision > 1.0f ? 1.0f : precision) *
+                            (recall > 1.0f ? 1.0f : recall);
+        if (n < limit)
+          n++;
+        else if (score <= best_score[n - 1])
+          continue;
+        uint8_t pos = n - 1;
+        while (pos > 0 && best_score[pos - 1] < score) {
+          best_score[pos] = best_score[pos - 1];
+          best_bit[pos] = best_bit[pos - 1];
+          pos--;
+        }
+        best_score[pos] = score;
+        best_bit[pos] = bit;
+      }
+
+      for (uint8_t r = 0; r < n; r++) {
+        const uint8_t bit = best_bit[r];
+        ESP_LOGI(tag,
+                 "    %-15s #%u bit %2u score %.2f (%u/%u toggles, %u events)",
+                 EVENT_NAMES[e], (unsigned)(r + 1), (unsigned)bit,
+                 best_score[r], (unsigned)slot.cooc[e][bit],
+                 (unsigned)slot.toggles[bit], (unsigned)events);
+      }
+    }
+  }
+}
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sauna360 {
+
+// Opt-in helper for reverse-engineering undecoded registers. For a few
+// selected heater codes it counts how often every bit toggles and how often
+// a toggle lands within `window_ms` of a known event (in either order).
+// Memory is fixed, cost per frame is bounded by 32 bits x NUM_EVENTS.
+class BitDiscovery {
+public:
+  enum Event : uint8_t {
+    EVENT_HEATER_ON = 0,
+    EVENT_HEATER_OFF,
+    EVENT_LIGHT_TOGGLE,
+    EVENT_DOOR_ERROR,
+    EVENT_SETPOINT_CHANGE,
+    NUM_EVENTS,
+  };
+  static constexpr uint8_t MAX_CODES = 8;
+
+  bool add_code(uint16_t code);
+  void set_window_ms(uint32_t ms) { this->window_ms_ = ms; }
+
+  // RX task
+  void on_frame(uint16_t code, uint32_t value, uint32_t now_ms);
+  void on_event(Event event, uint32_t now_ms);
+
+  // Logs the best-correlated bits per event and code
+  void log_report(const char *tag, uint8_t top_n = 3) const;
+
+protected:
+  struct Slot {
+    uint16_t code{0};
+    bool has_value{false};
+    uint32_t value{0};
+    uint32_t frames{0};
+    uint16_t toggles[32]{};
+    uint16_t cooc[NUM_EVENTS][32]{};
+    uint32_t last_toggle_ms[32]{};
+  };
+
+  static void inc_(uint16_t &counter) {
+    if (counter != 0xFFFF)
+      counter++;
+  }
+  bool within_(uint32_t then_ms, uint32_t now_ms) const {
+    return then_ms != 0 && (now_ms - then_ms) <= this->window_ms_;
+  }
+
+  Slot slots_[MAX_CODES];
+  uint8_t num_slots_{0};
+  uint32_t window_ms_{3000};
+  uint32_t last_event_ms_[NUM_EVENTS]{};
+  uint16_t event_count_[NUM_EVENTS]{};
+};
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+#include "esphome/core/hal.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef USE_HOST
+#include <pthread.h>
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#ifdef SAUNA360_RX_DMA
+#include "driver/uhci.h"
+#endif
+#endif
+
+// Sized from YAML (rx_task_stack_size); ESP-IDF only
+#ifndef SAUNA360_RX_STACK_SIZE
+#define SAUNA360_RX_STACK_SIZE 4096
+#endif
+
+namespace esphome {
+namespace sauna360 {
+
+// Byte transport and RX task for the RS485 bus.
+//
+// ESP-IDF (bus_port_idf.cpp): UART0 through the IDF driver, RX FIFO
+// threshold and timeout at one byte, RX task on a static stack pinned to
+// the app core.
+// ESP-IDF with rx_dma (SAUNA360_RX_DMA): UHCI feeds UART0 into GDMA
+// buffers and closes a buffer when the line goes idle, which on this bus
+// is after every frame. The RX task wakes once per frame and decodes the
+// DMA buffer in place; the IDF UART driver is removed and TX goes through
+// UHCI as well.
+// ESP-IDF with rs485 (SAUNA360_RS485): the UART runs in RS485 collision
+// detect mode and drives the transceiver's DE/RE from its RTS output. After
+// each frame tx_collided() waits until it has left the FIFO and reports
+// whether the echo differed from what was sent.
+// Host (bus_port_host.cpp): a serial device or PTY in raw 19200 8E1 and a
+// POSIX thread, for `platform: host` against a real adapter or a simulated
+// bus (tools/sauna360_heater_emulator.py).
+//
+// Timing uses micros() / delayMicroseconds() from the ESPHome HAL, which
+// all platforms provide.
+class BusPort {
+public:
+  using TaskFn = void (*)(void *ctx);
+  // UART the IDF backend owns; power management wakes on it
+  static constexpr int UART_PORT = 0;
+
+  // Host: path of the serial device or PTY
+  void set_device(const char *path) { this->device_ = path; }
+  const char *device() const { return this->device_; }
+
+  // Opens the bus and runs `fn(ctx)` on the RX task; `fn` does not return
+  bool start(TaskFn fn, void *ctx);
+
+  // RX task. Blocks for the next received bytes: one byte, or a frame with
+  // rx_dma. `end_us` is when the last of them ended (micros()). The data
+  // stays valid until the next call; 0 bytes on a read error.
+  size_t read(const uint8_t **data, uint32_t *end_us);
+  // Bytes received and not returned by read() yet. With rx_dma: frames
+  // queued plus bytes still in the RX FIFO; most of an unfinished frame is
+  // only visible to the DMA engine, so this is not a full carrier sense.
+  size_t available();
+  void write(const uint8_t *data, size_t len);
+  // Makes a read() blocked on the RX task return 0 bytes. Host: no-op, the
+  // read returns with the next byte.
+  void wake();
+  // RX task: drops everything received and not read yet
+  void flush_input();
+
+  // Busy-waits until `us` after `since_us`; returns at once if that passed
+  static void wait_after(uint32_t since_us, uint32_t us) {
+    const uint32_t elapsed = micros() - since_us;
+    if (elapsed < us)
+      delayMicroseconds(us - elapsed);
+  }
+
+  bool in_rx_task() const;
+  // Lowest free stack seen, bytes; 0 where the platform cannot tell
+  uint32_t rx_stack_free() const;
+  static uint32_t current_stack_free();
+
+#ifdef USE_HOST
+  pthread_t rx_task() const { return this->thread_; }
+#else
+  TaskHandle_t rx_task() const { return this->task_; }
+#endif
+
+#ifdef SAUNA360_RS485
+  // Longest wait for a frame to leave the UART
+  static constexpr uint32_t TX_DONE_TIMEOUT_MS = 20;
+  void set_de_pin(int pin) { this->de_pin_ = pin; }
+  int de_pin() const { return this->de_pin_; }
+  // RX task, after write(): blocks until the frame is out; true if the
+  // UART saw a collision while sending it
+  bool tx_collided();
+#endif
+
+#ifdef SAUNA360_RX_DMA
+  // Line idle time that closes a DMA buffer, in bit times: shorter than the
+  // smallest gap between frames, longer than any gap inside one
+  static constexpr uint32_t RX_DMA_IDLE_BITS = 6;
+  static constexpr size_t RX_DMA_BUF_LEN = 512;
+  static constexpr size_t RX_DMA_QUEUE_LEN = 16;
+  static constexpr size_t TX_DMA_SLOTS = 8;
+  static constexpr size_t TX_DMA_SLOT_LEN = 32;
+  // Frames lost because the RX task fell behind the DMA engine
+  uint32_t dma_overruns() const { return this->dma_overruns_; }
+#endif
+
+protected:
+  const char *device_{nullptr};
+  uint8_t rx_byte_{0};
+#ifdef USE_HOST
+  static void *thread_main_(void *arg);
+  int fd_{-1};
+  pthread_t thread_{};
+  bool started_{false};
+  TaskFn fn_{nullptr};
+  void *ctx_{nullptr};
+#else
+  TaskHandle_t task_{nullptr};
+#endif
+#ifdef SAUNA360_RS485
+  int de_pin_{-1};
+#endif
+#ifdef SAUNA360_RX_DMA
+  struct DmaChunk {
+    const uint8_t *data;
+    uint16_t len;
+    bool buffer_done; // DMA moved on to the other buffer
+    uint32_t end_us;
+  };
+  static bool on_dma_rx_(uhci_controller_handle_t ctrl,
+                         const uhci_rx_event_data_t *edata, void *ctx);
+  bool start_dma_();
+  uhci_controller_handle_t uhci_{nullptr};
+  QueueHandle_t dma_queue_{nullptr};
+  StaticQueue_t dma_queue_tcb_;
+  uint8_t dma_queue_storage_[RX_DMA_QUEUE_LEN * sizeof(DmaChunk)];
+  uint8_t dma_buf_{0}; // buffer the DMA engine is filling
+  uint8_t tx_slot_{0};
+  volatile uint32_t dma_overruns_{0};
+#endif
+};
+
+} // namespace sauna360
+} // namespace esphome
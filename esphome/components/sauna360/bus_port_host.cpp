@@ -0,0 +1,128 @@
+#include "bus_port.h"
+
+#ifdef USE_HOST
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace esphome {
+namespace sauna360 {
+
+static const char *const TAG = "sauna360.bus";
+
+bool BusPort::start(TaskFn fn, void *ctx) {
+  if (this->device_ == nullptr) {
+    ESP_LOGE(TAG, "No bus device configured");
+    return false;
+  }
+  this->fd_ = ::open(this->device_, O_RDWR | O_NOCTTY);
+  if (this->fd_ < 0) {
+    ESP_LOGE(TAG, "Cannot open %s: %s", this->device_, strerror(errno));
+    return false;
+  }
+
+  // Raw 19200 8E1, read() returns as soon as one byte is there. A PTY
+  // accepts and ignores the line settings.
+  struct termios tio;
+  if (tcgetattr(this->fd_, &tio) == 0) {
+    cfmakeraw(&tio);
+    cfsetispeed(&tio, B19200);
+    cfsetospeed(&tio, B19200);
+    tio.c_cflag |= CLOCAL | CREAD | PARENB;
+    tio.c_cflag &= ~(PARODD | CSTOPB | CSIZE);
+    tio.c_cflag |= CS8;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    tcsetattr(this->fd_, TCSANOW, &tio);
+  }
+
+  this->fn_ = fn;
+  this->ctx_ = ctx;
+  if (pthread_create(&this->thread_, nullptr, &BusPort::thread_main_, this) !=
+      0) {
+    ESP_LOGE(TAG, "Cannot start RX thread");
+    ::close(this->fd_);
+    this->fd_ = -1;
+    return false;
+  }
+  this->started_ = true;
+
+  // Closest match to the RX task priority; needs CAP_SYS_NICE
+  struct sched_param sp;
+  sp.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  if (pthread_setschedparam(this->thread_, SCHED_FIFO, &sp) != 0)
+    ESP_LOGD(TAG, "RX thread runs without real-time priority");
+  ESP_LOGI(TAG, "Bus on %s", this->device_);
+  return true;
+}
+
+void *BusPort::thread_main_(void *arg) {
+  auto *self = static_cast<BusPort *>(arg);
+  self->fn_(self->ctx_);
+  return nullptr;
+}
+
+// One byte at a time, like the IDF backend: the IFG calibrator needs the
+// arrival time of every byte
+size_t BusPort::read(const uint8_t **data, uint32_t *end_us) {
+  const ssize_t n = ::read(this->fd_, &this->rx_byte_, 1);
+  if (n == 1) {
+    *data = &this->rx_byte_;
+    *end_us = micros();
+    return 1;
+  }
+  if (n < 0 && errno == EINTR)
+    return 0;
+  // The other end of a PTY went away (EIO) or the device vanished; do not
+  // spin while the simulator restarts
+  delay(100);
+  return 0;
+}
+
+size_t BusPort::available() {
+  int n = 0;
+  if (ioctl(this->fd_, FIONREAD, &n) != 0 || n < 0)
+    return 0;
+  return static_cast<size_t>(n);
+}
+
+void BusPort::write(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    const ssize_t n = ::write(this->fd_, data, len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return;
+    }
+    data += n;
+    len -= static_cast<size_t>(n);
+  }
+}
+
+void BusPort::wake() {}
+
+void BusPort::flush_input() {
+  if (this->fd_ >= 0)
+    tcflush(this->fd_, TCIFLUSH);
+}
+
+bool BusPort::in_rx_task() const {
+  return this->started_ && pthread_equal(pthread_self(), this->thread_);
+}
+
+uint32_t BusPort::rx_stack_free() const { return 0; }
+
+uint32_t BusPort::current_stack_free() { return 0; }
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // USE_HOST
@@ -0,0 +1,229 @@
+#include "bus_port.h"
+
+#ifndef USE_HOST
+
+#include "esphome/core/log.h"
+
+#include "driver/uart.h"
+#include "sdkconfig.h"
+
+#ifdef SAUNA360_RX_DMA
+#include <cstring>
+
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "hal/uart_ll.h"
+
+#include "sauna360_protocol.h"
+#endif
+
+namespace esphome {
+namespace sauna360 {
+
+static const char *const TAG = "sauna360.bus";
+
+static constexpr uart_port_t PORT =
+    static_cast<uart_port_t>(BusPort::UART_PORT);
+
+// One bus per node, so file scope is enough
+static StackType_t rx_task_stack[SAUNA360_RX_STACK_SIZE / sizeof(StackType_t)];
+static StaticTask_t rx_task_tcb;
+
+#ifdef SAUNA360_RX_DMA
+static_assert(protocol::MAX_FRAME_LEN <= BusPort::TX_DMA_SLOT_LEN,
+              "TX DMA slot too small for a frame");
+// 19200 baud
+static constexpr uint32_t RX_DMA_IDLE_US =
+    BusPort::RX_DMA_IDLE_BITS * 1000000u / 19200u;
+
+// Internal RAM; DMA_ATTR keeps the buffers word aligned
+static DMA_ATTR uint8_t rx_dma_buf[2][BusPort::RX_DMA_BUF_LEN];
+static DMA_ATTR uint8_t
+    tx_dma_buf[BusPort::TX_DMA_SLOTS][BusPort::TX_DMA_SLOT_LEN];
+
+// ISR: one call per idle-terminated frame
+bool IRAM_ATTR BusPort::on_dma_rx_(uhci_controller_handle_t ctrl,
+                                   const uhci_rx_event_data_t *edata,
+                                   void *ctx) {
+  auto *self = static_cast<BusPort *>(ctx);
+  DmaChunk chunk;
+  chunk.data = edata->data;
+  chunk.len = static_cast<uint16_t>(edata->recv_size);
+  chunk.buffer_done = edata->flags.totally_received;
+  // The line has been idle for RX_DMA_IDLE_BITS since the last stop bit
+  chunk.end_us = static_cast<uint32_t>(esp_timer_get_time()) - RX_DMA_IDLE_US;
+  BaseType_t woken = pdFALSE;
+  if (xQueueSendFromISR(self->dma_queue_, &chunk, &woken) != pdTRUE)
+    self->dma_overruns_ = self->dma_overruns_ + 1;
+  return woken == pdTRUE;
+}
+
+bool BusPort::start_dma_() {
+  // The UART driver's ISR would compete with UHCI for the RX FIFO. Baud
+  // rate, parity and pins from the uart: component stay in the registers.
+  uart_driver_delete(PORT);
+
+  uhci_controller_config_t cfg = {};
+  cfg.uart_port = PORT;
+  // One slot more than can be in flight, so a slot is free before reuse
+  cfg.tx_trans_queue_depth = TX_DMA_SLOTS - 1;
+  cfg.max_transmit_size = TX_DMA_SLOT_LEN;
+  cfg.max_receive_internal_mem = sizeof(rx_dma_buf);
+  cfg.rx_eof_flags.idle_eof = 1;
+  esp_err_t err = uhci_new_controller(&cfg, &this->uhci_);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "UHCI setup failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  uart_ll_set_rx_idle_thr(UART_LL_GET_HW(PORT), RX_DMA_IDLE_BITS);
+
+  this->dma_queue_ =
+      xQueueCreateStatic(RX_DMA_QUEUE_LEN, sizeof(DmaChunk),
+                         this->dma_queue_storage_, &this->dma_queue_tcb_);
+  uhci_event_callbacks_t cbs = {};
+  cbs.on_rx_trans_event = &BusPort::on_dma_rx_;
+  uhci_register_event_callbacks(this->uhci_, &cbs, this);
+  this->dma_buf_ = 0;
+  err = uhci_receive(this->uhci_, rx_dma_buf[0], RX_DMA_BUF_LEN);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "UHCI receive failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  ESP_LOGI(TAG, "RX DMA: frames end after %u bit times idle",
+           (unsigned)RX_DMA_IDLE_BITS);
+  return true;
+}
+#endif
+
+bool BusPort::start(TaskFn fn, void *ctx) {
+#ifdef SAUNA360_RX_DMA
+  if (!this->start_dma_())
+    return false;
+#else
+  // UART low-latency: hand every byte to the task as it arrives
+  uart_set_rx_full_threshold(PORT, 1);
+  uart_set_rx_timeout(PORT, 1);
+#endif
+#ifdef SAUNA360_RS485
+  // The UART raises DE on RTS for each write and compares the echo with
+  // the transmitted bytes; RE must stay enabled so the echo comes back
+  uart_set_pin(PORT, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE, this->de_pin_,
+               UART_PIN_NO_CHANGE);
+  const esp_err_t err = uart_set_mode(PORT, UART_MODE_RS485_COLLISION_DETECT);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "RS485 mode failed: %s", esp_err_to_name(err));
+    return false;
+  }
+  ESP_LOGI(TAG, "RS485 collision detect, DE on GPIO%d", this->de_pin_);
+#endif
+
+#if CONFIG_FREERTOS_UNICORE
+  const BaseType_t core_id = 0;
+#else
+  const BaseType_t core_id = 1;
+#endif
+  this->task_ = xTaskCreateStaticPinnedToCore(
+      fn, "sauna_rx_fast", SAUNA360_RX_STACK_SIZE / sizeof(StackType_t), ctx,
+      configMAX_PRIORITIES - 3, rx_task_stack, &rx_task_tcb, core_id);
+  return this->task_ != nullptr;
+}
+
+size_t BusPort::read(const uint8_t **data, uint32_t *end_us) {
+#ifdef SAUNA360_RX_DMA
+  DmaChunk chunk;
+  if (xQueueReceive(this->dma_queue_, &chunk, portMAX_DELAY) != pdTRUE)
+    return 0;
+  if (chunk.buffer_done) {
+    // Hand DMA the other buffer; this one is ours until it comes round again
+    this->dma_buf_ ^= 1;
+    uhci_receive(this->uhci_, rx_dma_buf[this->dma_buf_], RX_DMA_BUF_LEN);
+  }
+  *data = chunk.data;
+  *end_us = chunk.end_us;
+  return chunk.len;
+#else
+  if (uart_read_bytes(PORT, &this->rx_byte_, 1, portMAX_DELAY) != 1)
+    return 0;
+  *data = &this->rx_byte_;
+  *end_us = micros();
+  return 1;
+#endif
+}
+
+size_t BusPort::available() {
+#ifdef SAUNA360_RX_DMA
+  // Frames finished and queued, plus bytes GDMA has not pulled out of the
+  // FIFO yet. Bytes already in the DMA buffer of an unfinished frame stay
+  // invisible until the idle EOF.
+  return uxQueueMessagesWaiting(this->dma_queue_) +
+         uart_ll_get_rxfifo_len(UART_LL_GET_HW(PORT));
+#else
+  size_t n = 0;
+  (void)uart_get_buffered_data_len(PORT, &n);
+  return n;
+#endif
+}
+
+void BusPort::write(const uint8_t *data, size_t len) {
+#ifdef SAUNA360_RX_DMA
+  if (len > TX_DMA_SLOT_LEN)
+    return;
+  // DMA reads the slot after we return; the caller's buffer may not last
+  uint8_t *slot = tx_dma_buf[this->tx_slot_];
+  this->tx_slot_ = (this->tx_slot_ + 1) % TX_DMA_SLOTS;
+  memcpy(slot, data, len);
+  uhci_transmit(this->uhci_, slot, len);
+#else
+  uart_write_bytes(PORT, (const char *)data, len);
+#endif
+}
+
+void BusPort::wake() {
+  if (this->task_ != nullptr)
+    xTaskAbortDelay(this->task_);
+}
+
+void BusPort::flush_input() {
+#ifdef SAUNA360_RX_DMA
+  // Through read(), so finished buffers are handed back to the DMA engine
+  const uint8_t *data;
+  uint32_t end_us;
+  while (uxQueueMessagesWaiting(this->dma_queue_) != 0)
+    this->read(&data, &end_us);
+#else
+  uart_flush_input(PORT);
+#endif
+}
+
+#ifdef SAUNA360_RS485
+bool BusPort::tx_collided() {
+  // The driver clears the flag when a write starts and sets it from the
+  // RS485 clash, parity and framing interrupts while DE is up
+  if (uart_wait_tx_done(PORT, pdMS_TO_TICKS(TX_DONE_TIMEOUT_MS) + 1) !=
+      ESP_OK)
+    return false; // cannot tell; the echo check still sees the frame
+  bool collided = false;
+  uart_get_collision_flag(PORT, &collided);
+  return collided;
+}
+#endif
+
+bool BusPort::in_rx_task() const {
+  return xTaskGetCurrentTaskHandle() == this->task_;
+}
+
+// High-water marks are in bytes on ESP-IDF (StackType_t is uint8_t)
+uint32_t BusPort::rx_stack_free() const {
+  if (this->task_ == nullptr)
+    return 0;
+  return uxTaskGetStackHighWaterMark(this->task_) * sizeof(StackType_t);
+}
+
+uint32_t BusPort::current_stack_free() {
+  return uxTaskGetStackHighWaterMark(nullptr) * sizeof(StackType_t);
+}
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // !USE_HOST
@@ -95,6 +95,17 @@ namespace esphome
       this->publish_state();
     }
 
+    void Sauna360Climate::on_bus_available(bool available)
+    {
+      if (available)
+      {
+        return;
+      }
+      this->current_temperature_ = NAN;
+      this->current_temperature = NAN;
+      this->publish_state();
+    }
+
     void Sauna360Climate::set_controller(SAUNA360Component *controller)
     {
       this->controller_ = controller;
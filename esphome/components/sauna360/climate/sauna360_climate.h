@@ -24,6 +24,7 @@ namespace esphome
       void on_temperature(uint16_t temperature) override;
       void on_temperature_setting(uint16_t temperature_setting) override;
       void on_heater_status(bool heater_status) override;
+      void on_bus_available(bool available) override;
 
     private:
       float current_temperature_ = NAN;
@@ -0,0 +1,80 @@
+#include "custom_register.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace sauna360 {
+
+bool CustomRegisters::add(uint8_t direction, uint16_t code,
+                          uint8_t bit_offset, uint8_t bit_width,
+                          bool is_signed, float scale, float offset,
+                          CustomFieldSink *sink) {
+  if (this->count_ >= MAX_FIELDS || sink == nullptr)
+    return false;
+  Field &f = this->fields_[this->count_++];
+  f.key = (static_cast<uint32_t>(direction) << 16) | code;
+  f.bit_offset = bit_offset;
+  f.bit_width = bit_width;
+  f.is_signed = is_signed;
+  f.scale = scale;
+  f.offset = offset;
+  f.sink = sink;
+  f.last_raw = 0;
+  f.published = false;
+  return true;
+}
+
+void CustomRegisters::finalize() {
+  std::stable_sort(
+      this->fields_, this->fields_ + this->count_,
+      [](const Field &a, const Field &b) { return a.key < b.key; });
+}
+
+uint32_t CustomRegisters::extract(const Field &f, uint32_t data) {
+  const uint32_t mask =
+      (f.bit_width >= 32) ? 0xFFFFFFFFu : ((1u << f.bit_width) - 1u);
+  return (data >> f.bit_offset) & mask;
+}
+
+float CustomRegisters::convert(const Field &f, uint32_t raw) {
+  float v;
+  if (f.is_signed && f.bit_width < 32) {
+    const uint8_t shift = 32 - f.bit_width;
+    v = static_cast<float>(static_cast<int32_t>(raw << shift) >> shift);
+  } else if (f.is_signed) {
+    v = static_cast<float>(static_cast<int32_t>(raw));
+  } else {
+    v = static_cast<float>(raw);
+  }
+  return v * f.scale + f.offset;
+}
+
+void CustomRegisters::dispatch(uint8_t direction, uint16_t code,
+                               uint32_t data) {
+  const uint32_t key = (static_cast<uint32_t>(direction) << 16) | code;
+  Field *end = this->fields_ + this->count_;
+  Field *f = std::lower_bound(
+      this->fields_, end, key,
+      [](const Field &a, uint32_t k) { return a.key < k; });
+  for (; f != end && f->key == key; ++f) {
+    const uint32_t raw = extract(*f, data);
+    if (f->published && raw == f->last_raw)
+      continue;
+    f->last_raw = raw;
+    f->published = true;
+    f->sink->on_custom_value(raw, convert(*f, raw));
+  }
+}
+
+void CustomRegisters::invalidate() {
+  for (uint8_t i = 0; i < this->count_; i++) {
+    Field &f = this->fields_[i];
+    if (!f.published)
+      continue;
+    f.published = false;
+    f.sink->on_custom_unavailable();
+  }
+}
+
+} // namespace sauna360
+} // namespace esphome
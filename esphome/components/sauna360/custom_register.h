@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sauna360 {
+
+// Receives the decoded value of a YAML-declared register field
+class CustomFieldSink {
+public:
+  virtual void on_custom_value(uint32_t raw, float value) = 0;
+  // Bus lost: the value is unknown until the next frame
+  virtual void on_custom_unavailable() {}
+};
+
+// Register fields declared with `custom:` in the sensor, binary_sensor and
+// text_sensor platforms. Fields are sorted by (direction, code) once in
+// setup(); dispatch is a binary search plus a shift and mask per field, and
+// sinks are only called when the raw field value changes.
+class CustomRegisters {
+public:
+  static constexpr uint8_t MAX_FIELDS = 16;
+
+  struct Field {
+    uint32_t key; // (direction << 16) | code, as in RegisterMap
+    uint8_t bit_offset;
+    uint8_t bit_width;
+    bool is_signed;
+    float scale;
+    float offset;
+    CustomFieldSink *sink;
+    uint32_t last_raw;
+    bool published;
+  };
+
+  bool add(uint8_t direction, uint16_t code, uint8_t bit_offset,
+           uint8_t bit_width, bool is_signed, float scale, float offset,
+           CustomFieldSink *sink);
+  void finalize();
+  void dispatch(uint8_t direction, uint16_t code, uint32_t data);
+  void invalidate();
+
+  uint8_t size() const { return this->count_; }
+  const Field &field(uint8_t i) const { return this->fields_[i]; }
+
+  static uint32_t extract(const Field &f, uint32_t data);
+  static float convert(const Field &f, uint32_t raw);
+
+protected:
+  Field fields_[MAX_FIELDS];
+  uint8_t count_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,167 @@
+#include "cycle_learner.h"
+
+namespace esphome {
+namespace sauna360 {
+
+namespace {
+// a += (b - a) / 8 on unsigned values
+uint32_t ewma8(uint32_t a, uint32_t b) {
+  return static_cast<uint32_t>(static_cast<int32_t>(a) +
+                               static_cast<int32_t>(b - a) / 8);
+}
+} // namespace
+
+void CycleLearner::on_event(uint16_t key, uint32_t end_us) {
+  if (!this->started_) {
+    if (key != ANCHOR_CODE)
+      return;
+    this->started_ = true;
+    this->anchor_us_ = end_us;
+  } else if (key == ANCHOR_CODE) {
+    this->end_cycle_(end_us);
+  }
+
+  uint8_t index = 0;
+  if (this->cur_len_ < MAX_EVENTS) {
+    index = this->cur_len_++;
+    this->cur_[index] = {key, end_us - this->anchor_us_, 0};
+    if (index >= this->len_ || this->seq_[index].key != key)
+      this->diverged_ = true;
+  } else {
+    this->overflow_ = true;
+  }
+
+  if (key != KEY_WINDOW && key != ANCHOR_CODE)
+    return;
+
+  if (key == KEY_WINDOW) {
+    if (this->predicted_ && !this->diverged_) {
+      const int32_t diff = static_cast<int32_t>(end_us - this->predicted_us_);
+      const uint32_t error = static_cast<uint32_t>(diff < 0 ? -diff : diff);
+      this->error_sum_us_ += error;
+      this->errors_ = this->errors_ + 1;
+      if (error > this->error_max_us_)
+        this->error_max_us_ = error;
+    }
+    this->window_open_ = !this->overflow_;
+    this->window_used_ = false;
+    this->window_index_ = index;
+    this->window_us_ = end_us;
+  }
+  this->predict_();
+}
+
+void CycleLearner::on_frame_start(uint32_t start_us) {
+  if (!this->window_open_ ||
+      static_cast<int32_t>(start_us - this->window_us_) <= 0)
+    return; // the ack itself
+  this->window_open_ = false;
+  if (!this->window_used_) {
+    const uint32_t free_us = start_us - this->window_us_;
+    this->cur_[this->window_index_].free_us = free_us != 0 ? free_us : 1;
+  }
+}
+
+bool CycleLearner::should_defer(uint32_t airtime_us) {
+  if (!this->locked() || this->diverged_ || !this->window_open_)
+    return false;
+  const uint8_t index = this->window_index_;
+  if (this->seq_[index].free_us == 0 || this->fits_(index, airtime_us) ||
+      this->deferred_in_row_ >= this->windows()) {
+    this->deferred_in_row_ = 0;
+    return false;
+  }
+  for (uint8_t i = 0; i < this->len_; i++) {
+    if (i != index && this->seq_[i].key == KEY_WINDOW &&
+        this->fits_(i, airtime_us)) {
+      this->deferred_in_row_++;
+      this->deferred_ = this->deferred_ + 1;
+      return true;
+    }
+  }
+  this->deferred_in_row_ = 0;
+  return false;
+}
+
+void CycleLearner::on_sent(uint32_t wait_us) {
+  this->wait_sum_us_ += wait_us;
+  this->waits_ = this->waits_ + 1;
+}
+
+uint8_t CycleLearner::windows() const {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < this->len_; i++) {
+    if (this->seq_[i].key == KEY_WINDOW)
+      count++;
+  }
+  return count;
+}
+
+void CycleLearner::end_cycle_(uint32_t now_us) {
+  const uint32_t period = now_us - this->anchor_us_;
+  const bool same = !this->overflow_ && !this->diverged_ &&
+                    this->cur_len_ == this->len_;
+
+  if (period > MAX_PERIOD_US || this->overflow_) {
+    this->stable_ = 0;
+  } else if (same) {
+    for (uint8_t i = 0; i < this->len_; i++) {
+      Event &learned = this->seq_[i];
+      const Event &seen = this->cur_[i];
+      learned.offset_us = ewma8(learned.offset_us, seen.offset_us);
+      // Follow a shorter window at once, a longer one slowly
+      if (seen.free_us != 0) {
+        learned.free_us = (learned.free_us == 0 || seen.free_us < learned.free_us)
+                              ? seen.free_us
+                              : ewma8(learned.free_us, seen.free_us);
+      }
+    }
+    this->period_us_ = ewma8(this->period_us_, period);
+    this->misses_ = 0;
+    if (this->stable_ < LOCK_CYCLES) {
+      this->stable_ = this->stable_ + 1;
+      if (this->stable_ == LOCK_CYCLES)
+        this->lock_count_ = this->lock_count_ + 1;
+    }
+  } else if (!this->locked() || ++this->misses_ >= RELEARN_MISSES) {
+    // A locked order survives the odd cycle with an extra broadcast
+    for (uint8_t i = 0; i < this->cur_len_; i++)
+      this->seq_[i] = this->cur_[i];
+    this->len_ = this->cur_len_;
+    this->period_us_ = period;
+    this->stable_ = 1;
+    this->misses_ = 0;
+  }
+
+  this->anchor_us_ = now_us;
+  this->cur_len_ = 0;
+  this->overflow_ = false;
+  this->diverged_ = false;
+  this->window_open_ = false;
+}
+
+// Next window after the current event: later in this cycle, else the first
+// of the next one
+void CycleLearner::predict_() {
+  this->predicted_ = false;
+  if (!this->locked() || this->diverged_ || this->overflow_)
+    return;
+  for (uint8_t i = this->cur_len_; i < this->len_; i++) {
+    if (this->seq_[i].key == KEY_WINDOW) {
+      this->predicted_us_ = this->anchor_us_ + this->seq_[i].offset_us;
+      this->predicted_ = true;
+      return;
+    }
+  }
+  for (uint8_t i = 0; i < this->len_; i++) {
+    if (this->seq_[i].key == KEY_WINDOW) {
+      this->predicted_us_ =
+          this->anchor_us_ + this->period_us_ + this->seq_[i].offset_us;
+      this->predicted_ = true;
+      return;
+    }
+  }
+}
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sauna360 {
+
+// Learns the repeating order of the bus cycle and predicts the TX windows
+// (cycle_learner: in YAML).
+//
+// A cycle runs from one 0x6000 broadcast to the next. Its events are the
+// heater frames by code, the heater polls and the panel acks that open a TX
+// window, each with its offset from the cycle start. Once the same order has
+// been seen LOCK_CYCLES times in a row the offsets (EWMA) predict when the
+// next window opens; the error of each prediction is measured when the
+// window actually opens. A different order starts the learning over.
+//
+// Each window also learns its free time: panel ack EOF to the next frame on
+// the wire, from windows we did not transmit in. A batch that does not fit
+// the current window is held for the soonest window of the cycle that it
+// does fit (should_defer); if none does it goes out as before.
+//
+// RX task only, except the read-only accessors.
+class CycleLearner {
+public:
+  static constexpr uint16_t KEY_POLL = 0x0006;   // heater poll
+  static constexpr uint16_t KEY_WINDOW = 0x0007; // panel ack, TX window
+  static constexpr uint16_t ANCHOR_CODE = 0x6000;
+  static constexpr uint8_t MAX_EVENTS = 48;
+  static constexpr uint8_t LOCK_CYCLES = 3;
+  // Cycles in a row with another order before a locked cycle is relearned;
+  // fewer are taken as the odd extra broadcast
+  static constexpr uint8_t RELEARN_MISSES = 2;
+  // Longer than this between two cycle starts: the bus was down
+  static constexpr uint32_t MAX_PERIOD_US = 10000000;
+  // Room left in a window after the batch before it counts as a fit
+  static constexpr uint32_t FIT_MARGIN_US = 1000;
+
+  // RX task
+  void on_event(uint16_t key, uint32_t end_us);
+  // Any frame, with the time its SOF went on the wire; ends an open window
+  void on_frame_start(uint32_t start_us);
+  // Called at a window just reported through on_event(KEY_WINDOW) with the
+  // time the batch at the head of the queue needs, IFG included. True if a
+  // later window of the cycle fits it and this one does not.
+  bool should_defer(uint32_t airtime_us);
+  // We transmit in the current window; its free time is not sampled
+  void on_tx() { this->window_used_ = true; }
+  // Queued -> written, per frame
+  void on_sent(uint32_t wait_us);
+
+  bool locked() const { return this->stable_ >= LOCK_CYCLES; }
+  uint32_t period_us() const { return this->period_us_; }
+  uint8_t events() const { return this->len_; }
+  uint8_t windows() const;
+  uint32_t predictions() const { return this->errors_; }
+  // Predicted vs actual window opening, |error|
+  uint32_t error_avg_us() const {
+    return this->errors_ != 0 ? static_cast<uint32_t>(this->error_sum_us_ /
+                                                      this->errors_)
+                              : 0;
+  }
+  uint32_t error_max_us() const { return this->error_max_us_; }
+  uint32_t deferred() const { return this->deferred_; }
+  uint32_t wait_avg_us() const {
+    return this->waits_ != 0 ? static_cast<uint32_t>(this->wait_sum_us_ /
+                                                     this->waits_)
+                             : 0;
+  }
+  // Bumped on every lock, so loop() can log it once
+  uint32_t lock_count() const { return this->lock_count_; }
+
+protected:
+  struct Event {
+    uint16_t key;
+    uint32_t offset_us; // from the cycle start
+    uint32_t free_us;   // windows: learned free time, 0 = not sampled yet
+  };
+
+  void end_cycle_(uint32_t now_us);
+  void predict_();
+  bool fits_(uint8_t index, uint32_t airtime_us) const {
+    return this->seq_[index].free_us >= airtime_us + FIT_MARGIN_US;
+  }
+
+  // Learned cycle
+  Event seq_[MAX_EVENTS];
+  uint8_t len_{0};
+  volatile uint8_t stable_{0};
+  uint8_t misses_{0};
+  uint32_t period_us_{0};
+
+  // Cycle in progress
+  Event cur_[MAX_EVENTS];
+  uint8_t cur_len_{0};
+  bool started_{false};
+  bool overflow_{false};
+  bool diverged_{false}; // order differs from the learned one so far
+  uint32_t anchor_us_{0};
+
+  // Window in progress
+  bool window_open_{false};
+  bool window_used_{false};
+  uint8_t window_index_{0};
+  uint32_t window_us_{0};
+  uint8_t deferred_in_row_{0};
+
+  bool predicted_{false};
+  uint32_t predicted_us_{0};
+
+  uint64_t error_sum_us_{0};
+  volatile uint32_t errors_{0};
+  volatile uint32_t error_max_us_{0};
+  volatile uint32_t deferred_{0};
+  uint64_t wait_sum_us_{0};
+  volatile uint32_t waits_{0};
+  volatile uint32_t lock_count_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,337 @@
+#include "flight_recorder.h"
+
+#ifdef SAUNA360_FLIGHT_RECORDER
+
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+#include <ctime>
+
+#include "esp_heap_caps.h"
+
+namespace esphome {
+namespace sauna360 {
+
+static const char *const TAG = "sauna360.recorder";
+
+const char *FlightRecorder::reason_name(uint8_t reason) {
+  switch (reason) {
+  case REASON_MANUAL:
+    return "manual";
+  case REASON_CODE:
+    return "code";
+  case REASON_CRC_BURST:
+    return "crc_burst";
+  case REASON_HEATER_STATE:
+    return "heater_state";
+  default:
+    return "unknown";
+  }
+}
+
+bool FlightRecorder::add_code(uint16_t code) {
+  if (this->code_count_ >= MAX_CODES)
+    return false;
+  this->codes_[this->code_count_++] = code;
+  return true;
+}
+
+void FlightRecorder::set_crc_burst(uint8_t count, uint32_t window_ms) {
+  this->crc_count_ = count < MAX_CRC_BURST ? count : MAX_CRC_BURST;
+  this->crc_window_ms_ = window_ms;
+}
+
+bool FlightRecorder::setup() {
+  this->part_ = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, this->label_);
+  if (this->part_ == nullptr) {
+    ESP_LOGE(TAG, "Partition '%s' not found", this->label_);
+    return false;
+  }
+
+  // PSRAM if fitted; otherwise as much internal RAM as can be had
+  uint32_t records = this->capacity_;
+  void *ring = heap_caps_malloc(records * sizeof(Record),
+                                MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  this->psram_ = ring != nullptr;
+  while (ring == nullptr && records >= MIN_RECORDS) {
+    ring = heap_caps_malloc(records * sizeof(Record),
+                            MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (ring == nullptr)
+      records /= 2;
+  }
+  if (ring == nullptr) {
+    ESP_LOGE(TAG, "No memory for %u records", (unsigned)MIN_RECORDS);
+    this->part_ = nullptr;
+    return false;
+  }
+  if (records != this->capacity_)
+    ESP_LOGW(TAG, "Ring reduced to %u records", (unsigned)records);
+  this->capacity_ = records;
+
+  this->slot_size_ = (sizeof(Header) + records * sizeof(Record) +
+                      SECTOR_SIZE - 1) /
+                     SECTOR_SIZE * SECTOR_SIZE;
+  this->slots_ = this->part_->size / this->slot_size_;
+  if (this->slots_ == 0) {
+    ESP_LOGE(TAG, "Partition '%s' too small for %u records", this->label_,
+             (unsigned)records);
+    heap_caps_free(ring);
+    this->part_ = nullptr;
+    return false;
+  }
+
+  // Continue after the newest capture, overwriting the oldest
+  Header h;
+  uint32_t newest_seq = 0;
+  this->count_ = 0;
+  for (uint32_t slot = 0; slot < this->slots_; slot++) {
+    if (!this->read_header(slot, &h))
+      continue;
+    this->count_++;
+    if (h.seq >= newest_seq) {
+      newest_seq = h.seq;
+      this->next_slot_ = (slot + 1) % this->slots_;
+    }
+  }
+  this->next_seq_ = newest_seq + 1;
+
+  this->ring_ = static_cast<Record *>(ring);
+  this->armed_us_ = micros();
+  ESP_LOGD(TAG, "%u captures in '%s', next slot %u", (unsigned)this->count_,
+           this->label_, (unsigned)this->next_slot_);
+  return true;
+}
+
+// RX task. The cost per frame is the header and a memcpy.
+void FlightRecorder::record(const uint8_t *data, size_t len, uint8_t flags,
+                            uint32_t time_us) {
+  const uint8_t state = this->state_.load(std::memory_order_acquire);
+  if (this->ring_ == nullptr || state >= FROZEN)
+    return;
+  if (len > sizeof(Record::data)) {
+    len = sizeof(Record::data);
+    flags |= protocol::REC_TRUNC;
+  }
+  const uint32_t i = this->head_;
+  Record &r = this->ring_[i & (this->capacity_ - 1)];
+  r.len = static_cast<uint8_t>(len);
+  r.flags = flags;
+  r.seq = static_cast<uint16_t>(i);
+  r.time_us = time_us;
+  memcpy(r.data, data, len);
+  this->head_ = i + 1;
+
+  if (state == PENDING) {
+    // Triggers fire while the frame is decoded, before it is recorded
+    this->promote_(i, time_us);
+  } else if (state == TRIGGERED &&
+             i - this->trigger_index_ >= this->capacity_ / 2) {
+    // Keep half of the ring for the pre-trigger history
+    uint8_t expected = TRIGGERED;
+    this->state_.compare_exchange_strong(expected, FROZEN);
+  }
+}
+
+bool FlightRecorder::snapshot_due(uint32_t now_ms) {
+  if (this->ring_ == nullptr || this->state_.load() >= FROZEN ||
+      (now_ms - this->last_snapshot_ms_) < SNAPSHOT_INTERVAL_MS)
+    return false;
+  this->last_snapshot_ms_ = now_ms;
+  return true;
+}
+
+void FlightRecorder::on_frame(uint16_t code, uint32_t data) {
+  for (uint8_t k = 0; k < this->code_count_; k++) {
+    if (this->codes_[k] != code)
+      continue;
+    const uint8_t bit = 1u << k;
+    const bool changed =
+        (this->code_seen_ & bit) == 0 || this->code_data_[k] != data;
+    this->code_seen_ |= bit;
+    this->code_data_[k] = data;
+    if (changed)
+      this->trigger(REASON_CODE, code, data);
+    return;
+  }
+}
+
+void FlightRecorder::on_crc_error(uint32_t now_ms) {
+  if (this->crc_count_ == 0)
+    return;
+  this->crc_times_[this->crc_seen_ % this->crc_count_] = now_ms;
+  this->crc_seen_++;
+  // The slot written next holds the oldest of the last crc_count_ errors
+  if (this->crc_seen_ >= this->crc_count_ &&
+      (now_ms - this->crc_times_[this->crc_seen_ % this->crc_count_]) <=
+          this->crc_window_ms_)
+    this->trigger(REASON_CRC_BURST);
+}
+
+bool FlightRecorder::trigger(Reason reason, uint16_t code, uint32_t data) {
+  if (this->ring_ == nullptr || (micros() - this->armed_us_) < this->pre_us_)
+    return false;
+  uint8_t expected = ARMED;
+  if (!this->state_.compare_exchange_strong(expected, BUSY))
+    return false;
+  this->reason_ = reason;
+  this->code_ = code;
+  this->data_ = data;
+  this->pending_ms_ = millis();
+  this->state_.store(PENDING, std::memory_order_release);
+  return true;
+}
+
+void FlightRecorder::promote_(uint32_t index, uint32_t time_us) {
+  uint8_t expected = PENDING;
+  if (!this->state_.compare_exchange_strong(expected, BUSY))
+    return;
+  this->trigger_index_ = index;
+  this->trigger_us_ = time_us;
+  this->state_.store(TRIGGERED, std::memory_order_release);
+}
+
+void FlightRecorder::loop() {
+  switch (this->state_.load(std::memory_order_acquire)) {
+  case PENDING:
+    if ((millis() - this->pending_ms_) >= PROMOTE_AFTER_MS)
+      this->promote_(this->head_, micros());
+    break;
+  case TRIGGERED:
+    if ((micros() - this->trigger_us_) >= this->post_us_) {
+      uint8_t expected = TRIGGERED;
+      this->state_.compare_exchange_strong(expected, FROZEN);
+    }
+    break;
+  case FROZEN:
+    this->begin_save_();
+    break;
+  case SAVING:
+    this->save_step_();
+    break;
+  default:
+    break;
+  }
+}
+
+void FlightRecorder::begin_save_() {
+  const uint32_t mask = this->capacity_ - 1;
+  const uint32_t end = this->head_;
+  const uint32_t oldest = end > this->capacity_ ? end - this->capacity_ : 0;
+  uint32_t trigger = this->trigger_index_;
+  if (trigger > end)
+    trigger = end;
+  if (trigger < oldest)
+    trigger = oldest;
+  uint32_t start = trigger;
+  while (start > oldest &&
+         (this->trigger_us_ - this->ring_[(start - 1) & mask].time_us) <=
+             this->pre_us_)
+    start--;
+
+  Header &h = this->save_header_;
+  memset(&h, 0, sizeof(h));
+  h.magic = MAGIC;
+  h.version = VERSION;
+  h.reason = this->reason_;
+  h.code = this->code_;
+  h.seq = this->next_seq_;
+  // Before SNTP the clock counts from 1970; store 0 rather than nonsense
+  const time_t t = ::time(nullptr);
+  h.unix_time = t > 1600000000 ? static_cast<uint32_t>(t) : 0;
+  h.trigger_us = this->trigger_us_;
+  h.data = this->data_;
+  h.count = end - start;
+  h.trigger_index = static_cast<uint16_t>(trigger - start);
+
+  ESP_LOGI(TAG, "Triggered (%s), saving %u records to slot %u",
+           reason_name(h.reason), (unsigned)h.count,
+           (unsigned)this->next_slot_);
+  this->save_start_ = start;
+  this->save_end_ = end;
+  this->save_next_ = start;
+  this->erase_pos_ = 0;
+  this->erase_len_ = (sizeof(Header) + h.count * sizeof(Record) +
+                      SECTOR_SIZE - 1) /
+                     SECTOR_SIZE * SECTOR_SIZE;
+  Header old;
+  if (this->read_header(this->next_slot_, &old) && this->count_ > 0)
+    this->count_--;
+  this->state_.store(SAVING);
+}
+
+// One flash operation per call: erasing a sector stalls both cores for
+// tens of milliseconds
+void FlightRecorder::save_step_() {
+  const uint32_t base = this->slot_offset_(this->next_slot_);
+  bool ok;
+  if (this->erase_pos_ < this->erase_len_) {
+    ok = esp_partition_erase_range(this->part_, base + this->erase_pos_,
+                                   SECTOR_SIZE) == ESP_OK;
+    this->erase_pos_ += SECTOR_SIZE;
+    if (ok)
+      return;
+  } else if (this->save_next_ < this->save_end_) {
+    const uint32_t mask = this->capacity_ - 1;
+    uint32_t n = this->save_end_ - this->save_next_;
+    const uint32_t contiguous = this->capacity_ - (this->save_next_ & mask);
+    if (n > contiguous)
+      n = contiguous;
+    if (n > SECTOR_SIZE / sizeof(Record))
+      n = SECTOR_SIZE / sizeof(Record);
+    const uint32_t offset =
+        base + sizeof(Header) +
+        (this->save_next_ - this->save_start_) * sizeof(Record);
+    ok = esp_partition_write(this->part_, offset,
+                             &this->ring_[this->save_next_ & mask],
+                             n * sizeof(Record)) == ESP_OK;
+    this->save_next_ += n;
+    if (ok)
+      return;
+  } else {
+    Header &h = this->save_header_;
+    h.crc = protocol::crc16(reinterpret_cast<const uint8_t *>(&h),
+                            offsetof(Header, crc));
+    ok = esp_partition_write(this->part_, base, &h, sizeof(h)) == ESP_OK;
+    if (ok) {
+      ESP_LOGI(TAG, "Capture #%u saved, %u records", (unsigned)h.seq,
+               (unsigned)h.count);
+      this->count_++;
+      this->next_seq_++;
+    }
+  }
+
+  // Saved, or given up; the slot is used up either way
+  if (!ok)
+    ESP_LOGW(TAG, "Flash write failed in slot %u, capture dropped",
+             (unsigned)this->next_slot_);
+  this->next_slot_ = (this->next_slot_ + 1) % this->slots_;
+  this->armed_us_ = micros();
+  this->state_.store(ARMED, std::memory_order_release);
+}
+
+bool FlightRecorder::read_header(uint32_t slot, Header *out) const {
+  if (this->part_ == nullptr || slot >= this->slots_ ||
+      esp_partition_read(this->part_, this->slot_offset_(slot), out,
+                         sizeof(Header)) != ESP_OK)
+    return false;
+  return out->magic == MAGIC && out->version == VERSION &&
+         out->crc == protocol::crc16(reinterpret_cast<const uint8_t *>(out),
+                                     offsetof(Header, crc));
+}
+
+bool FlightRecorder::read_record(uint32_t slot, uint32_t i,
+                                 Record *out) const {
+  if (this->part_ == nullptr || slot >= this->slots_)
+    return false;
+  return esp_partition_read(this->part_,
+                            this->slot_offset_(slot) + sizeof(Header) +
+                                i * sizeof(Record),
+                            out, sizeof(Record)) == ESP_OK;
+}
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // SAUNA360_FLIGHT_RECORDER
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef SAUNA360_FLIGHT_RECORDER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_partition.h"
+
+#include "sauna360_protocol.h"
+
+namespace esphome {
+namespace sauna360 {
+
+// Triggered bus capture for post-mortem analysis (flight_recorder: in YAML).
+//
+// The RX task copies every frame, received or sent, into a ring of fixed
+// 32-byte records (the frame stream header and the raw bytes), in PSRAM
+// when there is some. Once a second a snapshot of the decoded state goes in
+// as well. A trigger (a watched code changing, a burst of CRC errors, a
+// heater state change, or the recorder_trigger action) marks the record it
+// fires on; recording goes on for post_trigger, then the ring is frozen and
+// loop() saves pre_trigger before the trigger to the end into the next slot
+// of a flash partition, one sector erase or write per call. The slot header
+// is written last, so a capture cut short by a reset is simply absent.
+// Triggers are ignored until the ring holds pre_trigger of history again.
+//
+// Frames that arrive while a capture is being saved are not recorded.
+class FlightRecorder {
+public:
+  enum Reason : uint8_t {
+    REASON_MANUAL = 0,
+    REASON_CODE = 1,         // watched code changed its data
+    REASON_CRC_BURST = 2,    // crc_errors within crc_window
+    REASON_HEATER_STATE = 3, // heater state text changed
+  };
+  static const char *reason_name(uint8_t reason);
+
+  struct Record {
+    uint8_t len;
+    uint8_t flags; // protocol::REC_*
+    uint16_t seq;
+    uint32_t time_us;
+    uint8_t data[24];
+  };
+  static_assert(sizeof(Record) == 32, "recorder record must be 32 bytes");
+  static_assert(protocol::MAX_FRAME_LEN <= sizeof(Record::data),
+                "frame does not fit a recorder record");
+
+  // Data of a REC_SNAPSHOT record
+  enum SnapshotFlag : uint8_t {
+    SNAP_HEATER_ON = 1 << 0,
+    SNAP_LIGHT_ON = 1 << 1,
+    SNAP_SESSION = 1 << 2,
+    SNAP_HEATING = 1 << 3,
+    SNAP_BUS_UP = 1 << 4,
+  };
+  struct Snapshot {
+    uint16_t temperature_raw; // C * 9
+    uint16_t setpoint_raw;    // C * 9
+    uint16_t bath_time_raw;   // 0x4002, low 12 bits
+    uint8_t flags;            // SNAP_*
+    uint8_t reserved;
+    char state[16]; // heater state text, truncated, zero padded
+  };
+  static_assert(sizeof(Snapshot) == sizeof(Record::data),
+                "snapshot must fill the record data");
+
+  // Start of a flash slot; the records follow it
+  struct Header {
+    uint32_t magic; // MAGIC; anything else = empty slot
+    uint8_t version;
+    uint8_t reason; // Reason
+    uint16_t code;  // REASON_CODE: the code that changed
+    uint32_t seq;   // capture number
+    uint32_t unix_time; // 0 if the clock was not set
+    uint32_t trigger_us; // micros() at the trigger
+    uint32_t data;       // REASON_CODE: its new data
+    uint32_t count;      // records in the slot
+    uint16_t trigger_index; // record the trigger fired on
+    uint16_t crc; // protocol::crc16 over the preceding 30 bytes
+  };
+  static_assert(sizeof(Header) == 32, "recorder header must be 32 bytes");
+
+  static constexpr uint32_t MAGIC = 0x52363353; // "S36R"
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint32_t SECTOR_SIZE = 4096;
+  static constexpr uint8_t MAX_CODES = 8;
+  static constexpr uint8_t MAX_CRC_BURST = 16;
+  static constexpr uint32_t SNAPSHOT_INTERVAL_MS = 1000;
+  static constexpr uint32_t MIN_RECORDS = 256;
+
+  void set_partition_label(const char *label) { this->label_ = label; }
+  const char *partition_label() const { return this->label_; }
+  // Power of two; the post-trigger part may use at most half of it
+  void set_records(uint32_t records) { this->capacity_ = records; }
+  void set_windows(uint32_t pre_ms, uint32_t post_ms) {
+    this->pre_us_ = pre_ms * 1000u;
+    this->post_us_ = post_ms * 1000u;
+  }
+  bool add_code(uint16_t code);
+  void set_crc_burst(uint8_t count, uint32_t window_ms);
+  void set_heater_state_trigger(bool enable) { this->on_state_ = enable; }
+
+  // Finds the partition and the newest capture, then allocates the ring
+  bool setup();
+  bool ready() const { return this->ring_ != nullptr; }
+  bool in_psram() const { return this->psram_; }
+  uint32_t records() const { return this->capacity_; }
+  uint32_t pre_ms() const { return this->pre_us_ / 1000u; }
+  uint32_t post_ms() const { return this->post_us_ / 1000u; }
+
+  // RX task
+  void record(const uint8_t *data, size_t len, uint8_t flags,
+              uint32_t time_us);
+  bool snapshot_due(uint32_t now_ms);
+  void on_frame(uint16_t code, uint32_t data);
+  void on_crc_error(uint32_t now_ms);
+  void on_heater_state() {
+    if (this->on_state_)
+      this->trigger(REASON_HEATER_STATE);
+  }
+
+  // Any task. False if a capture is already under way or the ring does not
+  // hold pre_trigger of history yet.
+  bool trigger(Reason reason, uint16_t code = 0, uint32_t data = 0);
+
+  // Main loop: ends the post-trigger window and saves the capture
+  void loop();
+  bool busy() const { return this->state_.load() != ARMED; }
+
+  // Flash slots in partition order, not by age
+  uint32_t slots() const { return this->slots_; }
+  uint32_t count() const { return this->count_; }
+  // False for an empty or corrupt slot
+  bool read_header(uint32_t slot, Header *out) const;
+  bool read_record(uint32_t slot, uint32_t i, Record *out) const;
+
+protected:
+  enum State : uint8_t {
+    ARMED,
+    BUSY, // a trigger or promotion is filling in its fields
+    PENDING,
+    TRIGGERED,
+    FROZEN,
+    SAVING,
+  };
+  // Quiet bus: the loop marks the next record as the trigger instead
+  static constexpr uint32_t PROMOTE_AFTER_MS = 100;
+
+  void promote_(uint32_t index, uint32_t time_us);
+  void begin_save_();
+  void save_step_();
+  uint32_t slot_offset_(uint32_t slot) const {
+    return slot * this->slot_size_;
+  }
+
+  const char *label_{"sauna_recorder"};
+  const esp_partition_t *part_{nullptr};
+  uint32_t slot_size_{0};
+  uint32_t slots_{0};
+  uint32_t count_{0};
+  uint32_t next_slot_{0};
+  uint32_t next_seq_{1};
+
+  Record *ring_{nullptr};
+  uint32_t capacity_{2048};
+  bool psram_{false};
+  uint32_t pre_us_{30000000};
+  uint32_t post_us_{10000000};
+
+  std::atomic<uint8_t> state_{ARMED};
+  volatile uint32_t head_{0}; // records written since setup
+  uint32_t armed_us_{0};      // triggers allowed pre_us_ after this
+  uint32_t last_snapshot_ms_{0};
+
+  // Trigger, written under BUSY
+  uint8_t reason_{REASON_MANUAL};
+  uint16_t code_{0};
+  uint32_t data_{0};
+  uint32_t pending_ms_{0};
+  uint32_t trigger_index_{0};
+  uint32_t trigger_us_{0};
+
+  uint16_t codes_[MAX_CODES];
+  uint32_t code_data_[MAX_CODES];
+  uint8_t code_count_{0};
+  uint8_t code_seen_{0}; // bit per code
+  bool on_state_{false};
+  uint8_t crc_count_{0};
+  uint32_t crc_window_ms_{0};
+  uint32_t crc_times_[MAX_CRC_BURST];
+  uint32_t crc_seen_{0};
+
+  // Save in progress: ring indexes [save_start_, save_end_)
+  Header save_header_{};
+  uint32_t save_start_{0};
+  uint32_t save_end_{0};
+  uint32_t save_next_{0}; // next ring index to write
+  uint32_t erase_pos_{0}; // bytes of the slot erased so far
+  uint32_t erase_len_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // SAUNA360_FLIGHT_RECORDER
@@ -0,0 +1,141 @@
+#include "frame_stream.h"
+
+#ifdef SAUNA360_FRAME_STREAM
+
+#include "esphome/core/log.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include "lwip/sockets.h"
+
+namespace esphome {
+namespace sauna360 {
+
+static const char *const TAG = "sauna360.stream";
+
+static constexpr uint32_t STREAM_TASK_STACK = 3072;
+static StackType_t stream_task_stack[STREAM_TASK_STACK / sizeof(StackType_t)];
+static StaticTask_t stream_task_tcb;
+
+void FrameStream::start() {
+  this->task_handle_ = xTaskCreateStatic(
+      task_, "sauna_stream", STREAM_TASK_STACK / sizeof(StackType_t), this,
+      tskIDLE_PRIORITY + 1, stream_task_stack, &stream_task_tcb);
+}
+
+void FrameStream::push(const uint8_t *data, size_t len, uint8_t flags,
+                       uint32_t time_us) {
+  if (!this->connected_.load(std::memory_order_relaxed))
+    return;
+  const uint16_t seq = this->seq_++;
+  const uint16_t tail = this->tail_.load(std::memory_order_relaxed);
+  const uint16_t head = this->head_.load(std::memory_order_acquire);
+  if (static_cast<uint16_t>(tail - head) >= RING_LEN) {
+    this->dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (len > protocol::MAX_FRAME_LEN) {
+    len = protocol::MAX_FRAME_LEN;
+    flags |= FLAG_TRUNC;
+  }
+  Record &r = this->ring_[tail & (RING_LEN - 1)];
+  r.header[0] = static_cast<uint8_t>(len);
+  r.header[1] = flags;
+  r.header[2] = static_cast<uint8_t>(seq);
+  r.header[3] = static_cast<uint8_t>(seq >> 8);
+  r.header[4] = static_cast<uint8_t>(time_us);
+  r.header[5] = static_cast<uint8_t>(time_us >> 8);
+  r.header[6] = static_cast<uint8_t>(time_us >> 16);
+  r.header[7] = static_cast<uint8_t>(time_us >> 24);
+  memcpy(r.data, data, len);
+  this->tail_.store(tail + 1, std::memory_order_release);
+  xTaskNotifyGive(this->task_handle_);
+}
+
+void FrameStream::task_(void *arg) {
+  auto *self = static_cast<FrameStream *>(arg);
+
+  // The network stack may not be up yet when setup() runs; keep retrying
+  int listen_fd = -1;
+  for (;;) {
+    listen_fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listen_fd >= 0) {
+      int one = 1;
+      setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+      sockaddr_in addr{};
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons(self->port_);
+      addr.sin_addr.s_addr = htonl(INADDR_ANY);
+      if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) ==
+              0 &&
+          listen(listen_fd, 1) == 0)
+        break;
+      close(listen_fd);
+    }
+    vTaskDelay(pdMS_TO_TICKS(5000));
+  }
+  ESP_LOGI(TAG, "Listening on port %u", (unsigned)self->port_);
+
+  int one = 1;
+  for (;;) {
+    const int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      continue;
+    }
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    self->serve_client_(fd);
+    close(fd);
+  }
+}
+
+void FrameStream::serve_client_(int fd) {
+  static const uint8_t HELLO[5] = {'S', '3', '6', '0', VERSION};
+  if (send(fd, HELLO, sizeof(HELLO), 0) != sizeof(HELLO))
+    return;
+
+  // Start from an empty ring; frames before the connect are not sent
+  this->head_.store(this->tail_.load(std::memory_order_acquire),
+                    std::memory_order_release);
+  this->connected_.store(true);
+  ESP_LOGI(TAG, "Client connected");
+
+  uint8_t buf[RING_LEN / 4 * sizeof(Record)];
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+    // Batch up to a quarter of the ring into one send()
+    size_t n = 0;
+    uint16_t head = this->head_.load(std::memory_order_relaxed);
+    const uint16_t tail = this->tail_.load(std::memory_order_acquire);
+    while (head != tail && n + sizeof(Record) <= sizeof(buf)) {
+      const Record &r = this->ring_[head & (RING_LEN - 1)];
+      const size_t len = HEADER_LEN + r.header[0];
+      memcpy(buf + n, &r, len);
+      n += len;
+      head++;
+    }
+    this->head_.store(head, std::memory_order_release);
+
+    if (n == 0) {
+      // Idle: detect a closed connection
+      uint8_t tmp;
+      const int r = recv(fd, &tmp, 1, MSG_DONTWAIT);
+      if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+        break;
+      continue;
+    }
+    if (send(fd, buf, n, 0) != static_cast<int>(n))
+      break;
+  }
+
+  this->connected_.store(false);
+  ESP_LOGI(TAG, "Client disconnected (%u frames dropped so far)",
+           (unsigned)this->dropped_.load());
+}
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // SAUNA360_FRAME_STREAM
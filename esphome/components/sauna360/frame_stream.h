@@ -0,0 +1,77 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef SAUNA360_FRAME_STREAM
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "sauna360_protocol.h"
+
+namespace esphome {
+namespace sauna360 {
+
+// Raw frame stream for external analysers (frame_stream: in YAML).
+//
+// The RX task pushes every received frame (valid or rejected) and every
+// frame we transmit into a lock-free single-producer ring; a separate
+// socket task drains it to one TCP client. Nothing is formatted on the
+// device. If the client cannot keep up the ring fills and new frames are
+// dropped and counted; the RX task never waits.
+//
+// Wire format, all little-endian. On connect the server sends
+//   "S360" u8 version(1)
+// followed by one record per frame:
+//   u8  len      number of frame bytes that follow the 8-byte header
+//   u8  flags    FLAG_* (protocol::REC_*)
+//   u16 seq      increments per frame, gaps = frames dropped on the device
+//   u32 time_us  receive (or transmit) time, micros(), wraps every 71 min
+//   u8  data[len] raw bytes on the wire, SOF..EOF, still escaped
+class FrameStream {
+public:
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint8_t FLAG_VALID = protocol::REC_VALID;
+  static constexpr uint8_t FLAG_PANEL = protocol::REC_PANEL;
+  static constexpr uint8_t FLAG_TX = protocol::REC_TX;
+  static constexpr uint8_t FLAG_TRUNC = protocol::REC_TRUNC;
+  static constexpr size_t HEADER_LEN = protocol::REC_HEADER_LEN;
+  static constexpr uint16_t RING_LEN = 64; // records, power of two
+
+  void set_port(uint16_t port) { this->port_ = port; }
+  uint16_t port() const { return this->port_; }
+  void start();
+
+  // RX task only. Cheap no-op while no client is connected.
+  void push(const uint8_t *data, size_t len, uint8_t flags, uint32_t time_us);
+
+  bool connected() const { return this->connected_.load(); }
+  uint32_t dropped() const { return this->dropped_.load(); }
+
+protected:
+  struct Record {
+    uint8_t header[HEADER_LEN];
+    uint8_t data[protocol::MAX_FRAME_LEN];
+  };
+
+  static void task_(void *arg);
+  void serve_client_(int fd);
+
+  uint16_t port_{6638};
+  Record ring_[RING_LEN];
+  std::atomic<uint16_t> head_{0}; // consumer
+  std::atomic<uint16_t> tail_{0}; // producer
+  uint16_t seq_{0};
+  std::atomic<bool> connected_{false};
+  std::atomic<uint32_t> dropped_{0};
+  TaskHandle_t task_handle_{nullptr};
+};
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // SAUNA360_FRAME_STREAM
@@ -0,0 +1,80 @@
+#include "heap_audit.h"
+
+#ifdef SAUNA360_HEAP_AUDIT
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace esphome {
+namespace sauna360 {
+namespace heap_audit {
+
+static std::atomic<uint32_t> rx_count{0};
+static std::atomic<uint32_t> loop_count{0};
+
+#ifdef USE_HOST
+// pthread_t has no null value; the flags say whether the ids are set
+static pthread_t rx_task;
+static pthread_t loop_task;
+static std::atomic<bool> rx_set{false};
+static std::atomic<bool> in_loop{false};
+
+void set_rx_task(TaskId task) {
+  rx_task = task;
+  rx_set.store(true);
+}
+void enter_loop() {
+  loop_task = pthread_self();
+  in_loop.store(true);
+}
+void exit_loop() { in_loop.store(false); }
+
+static inline void count() {
+  const pthread_t current = pthread_self();
+  if (rx_set.load(std::memory_order_relaxed) &&
+      pthread_equal(current, rx_task))
+    rx_count.fetch_add(1, std::memory_order_relaxed);
+  else if (in_loop.load(std::memory_order_relaxed) &&
+           pthread_equal(current, loop_task))
+    loop_count.fetch_add(1, std::memory_order_relaxed);
+}
+#else
+static TaskHandle_t rx_task = nullptr;
+static TaskHandle_t loop_task = nullptr; // set only while inside loop()
+
+void set_rx_task(TaskId task) { rx_task = task; }
+void enter_loop() { loop_task = xTaskGetCurrentTaskHandle(); }
+void exit_loop() { loop_task = nullptr; }
+
+static inline void count() {
+  const TaskHandle_t current = xTaskGetCurrentTaskHandle();
+  if (current == nullptr)
+    return;
+  if (current == rx_task)
+    rx_count.fetch_add(1, std::memory_order_relaxed);
+  else if (current == loop_task)
+    loop_count.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+uint32_t rx_allocs() { return rx_count.load(std::memory_order_relaxed); }
+uint32_t loop_allocs() { return loop_count.load(std::memory_order_relaxed); }
+
+} // namespace heap_audit
+} // namespace sauna360
+} // namespace esphome
+
+// new[] and the nothrow forms forward to this one by default
+void *operator new(size_t size) {
+  esphome::sauna360::heap_audit::count();
+  void *p = malloc(size != 0 ? size : 1);
+  if (p == nullptr)
+    abort(); // built with -fno-exceptions (ESP-IDF)
+  return p;
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+#endif // SAUNA360_HEAP_AUDIT
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef SAUNA360_HEAP_AUDIT
+
+#include <cstdint>
+
+#ifdef USE_HOST
+#include <pthread.h>
+#else
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+namespace esphome {
+namespace sauna360 {
+namespace heap_audit {
+
+// Debug aid (heap_audit: true): replaces the global operator new and counts
+// allocations made by the RX task and inside SAUNA360Component::loop().
+// Both counters must stay flat once the bus is running; on the host
+// tools/sauna360_heap_audit_test.py checks that.
+#ifdef USE_HOST
+using TaskId = pthread_t;
+#else
+using TaskId = TaskHandle_t;
+#endif
+
+void set_rx_task(TaskId task);
+uint32_t rx_allocs();
+uint32_t loop_allocs();
+
+void enter_loop();
+void exit_loop();
+
+struct LoopScope {
+  LoopScope() { enter_loop(); }
+  ~LoopScope() { exit_loop(); }
+};
+
+} // namespace heap_audit
+} // namespace sauna360
+} // namespace esphome
+
+#endif // SAUNA360_HEAP_AUDIT
@@ -0,0 +1,124 @@
+#include "ifg_calibrator.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace esphome {
+namespace sauna360 {
+
+void IFGCalibrator::on_byte(uint8_t b, uint32_t now_us, bool panel_eof) {
+  if (b == 0x98) {
+    this->in_frame_ = true;
+    this->sof_us_ = now_us;
+    this->frame_pos_ = 0;
+    return;
+  }
+  if (!this->in_frame_)
+    return;
+
+  this->frame_pos_++;
+  // 98 40 <type>: the type byte tells us who started talking
+  if (this->frame_pos_ == 2 && this->gap_pending_) {
+    this->gap_pending_ = false;
+    const bool from_panel = (b == 0x07) || (b == 0x09);
+    const Direction dir = from_panel ? DIR_PANEL : DIR_HEATER;
+    // Timestamps mark the end of a byte: subtract the SOF character itself
+    uint32_t gap = this->sof_us_ - this->panel_eof_us_;
+    gap = (gap > CHAR_TIME_US) ? gap - CHAR_TIME_US : 0;
+    const uint32_t bin = std::min<uint32_t>(gap / BIN_US, NUM_BINS - 1);
+    this->hist_[dir][bin]++;
+    this->samples_[dir]++;
+  }
+
+  if (b == 0x9C) {
+    this->in_frame_ = false;
+    // Only the first frame after a panel EOF is of interest
+    this->gap_pending_ = panel_eof;
+    if (panel_eof)
+      this->panel_eof_us_ = now_us;
+  }
+}
+
+bool IFGCalibrator::recalibrate() {
+  const uint32_t prev = this->delay_us_;
+
+  const uint32_t total =
+      this->samples_[DIR_HEATER] + this->samples_[DIR_PANEL];
+  if (total >= MIN_SAMPLES) {
+    // Ignore stray bins (noise, corrupted SOFs): < 0.5 % of samples
+    const uint32_t noise = std::max<uint32_t>(2, total / 200);
+    uint32_t learned = MIN_DELAY_US;
+    for (uint8_t bin = 0; bin < NUM_BINS - 1; bin++) {
+      const uint32_t bin_end_us = (bin + 1) * BIN_US;
+      if (bin_end_us > this->default_delay_us_)
+        break;
+      const uint32_t count =
+          this->hist_[DIR_HEATER][bin] + this->hist_[DIR_PANEL][bin];
+      // Somebody answers inside the window we would use: start after them
+      if (count >= noise)
+        learned = std::max(learned, bin_end_us + SAFETY_MARGIN_US);
+    }
+    if (learned == MIN_DELAY_US)
+      learned += SAFETY_MARGIN_US;
+    // Never slower than the model default
+    this->learned_delay_us_ = std::min(learned, this->default_delay_us_);
+  }
+  if (total >= AGE_SAMPLES) {
+    for (uint8_t dir = 0; dir < DIR_COUNT; dir++) {
+      this->samples_[dir] = 0;
+      for (uint8_t bin = 0; bin < NUM_BINS; bin++) {
+        this->hist_[dir][bin] /= 2;
+        this->samples_[dir] += this->hist_[dir][bin];
+      }
+    }
+  }
+
+  // Back off while collisions / CRC errors rise, recover slowly when clean
+  const uint32_t errors = this->errors_;
+  const uint32_t new_errors = errors - this->errors_seen_ + this->collisions_;
+  this->errors_seen_ = errors;
+  this->collisions_ = 0;
+  if (new_errors >= 2) {
+    this->backoff_us_ += BACKOFF_STEP_US;
+    this->clean_rounds_ = 0;
+  } else if (new_errors == 0 && this->backoff_us_ > 0 &&
+             ++this->clean_rounds_ >= 6) {
+    this->backoff_us_ -= BACKOFF_STEP_US;
+    this->clean_rounds_ = 0;
+  }
+
+  const uint32_t base = (this->learned_delay_us_ != 0)
+                            ? this->learned_delay_us_
+                            : this->default_delay_us_;
+  this->delay_us_ = std::min(base + this->backoff_us_, MAX_DELAY_US);
+  if (this->delay_us_ == MAX_DELAY_US)
+    this->backoff_us_ = MAX_DELAY_US - base;
+  return this->delay_us_ != prev;
+}
+
+size_t IFGCalibrator::histogram_str(char *out, size_t size) const {
+  static const char DIR_TAG[DIR_COUNT] = {'H', 'P'};
+  if (size == 0)
+    return 0;
+  size_t pos = 0;
+  out[0] = '\0';
+  for (uint8_t dir = 0; dir < DIR_COUNT && pos + 1 < size; dir++) {
+    int n = snprintf(out + pos, size - pos, "%s%c", dir ? " " : "",
+                     DIR_TAG[dir]);
+    pos = std::min(size - 1, pos + static_cast<size_t>(n));
+    char sep = ' ';
+    for (uint8_t bin = 0; bin < NUM_BINS && pos + 1 < size; bin++) {
+      const uint32_t count = this->hist_[dir][bin];
+      if (count == 0)
+        continue;
+      n = snprintf(out + pos, size - pos, "%c%u:%u", sep, (unsigned)bin,
+                   (unsigned)count);
+      pos = std::min(size - 1, pos + static_cast<size_t>(n));
+      sep = ',';
+    }
+  }
+  return pos;
+}
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sauna360 {
+
+// Learns the idle gap that follows the panel EOF on this particular bus and
+// derives the shortest TX delay that keeps clear of every other talker.
+//
+// The RX task feeds bytes with their receive timestamp (on_byte). After each
+// panel EOF the gap until the next SOF is binned by the direction of the frame
+// that starts talking (heater or panel side); our own frames are not
+// counted. recalibrate() runs from loop() and halves the histogram once it
+// holds AGE_SAMPLES, so old gaps fade out.
+//
+// CRC errors and echo collisions back the delay off. A slot given up
+// because someone else started first is not an error: the delay was too
+// long, not too short.
+class IFGCalibrator {
+public:
+  enum Direction : uint8_t { DIR_HEATER = 0, DIR_PANEL = 1, DIR_COUNT = 2 };
+
+  static constexpr uint32_t BIN_US = 250;
+  static constexpr uint8_t NUM_BINS = 64; // 0..16 ms, last bin = overflow
+  // One character at 19200 8E1 (11 bits)
+  static constexpr uint32_t CHAR_TIME_US = 573;
+  // Lower bound: the proven PURE delay
+  static constexpr uint32_t MIN_DELAY_US = 520;
+  static constexpr uint32_t MAX_DELAY_US = 10000;
+  static constexpr uint32_t SAFETY_MARGIN_US = 250;
+  static constexpr uint32_t BACKOFF_STEP_US = 250;
+  static constexpr uint32_t MIN_SAMPLES = 200;
+  static constexpr uint32_t AGE_SAMPLES = 2 * MIN_SAMPLES;
+
+  void set_default_delay_us(uint32_t us) {
+    this->default_delay_us_ = us;
+    this->delay_us_ = us;
+  }
+  uint32_t delay_us() const { return this->delay_us_; }
+
+  // RX task
+  void on_byte(uint8_t b, uint32_t now_us, bool panel_eof);
+  void on_crc_error() { this->errors_++; }
+  // We write after the panel EOF just seen: the gap is ours, not a talker's
+  void on_own_tx() { this->gap_pending_ = false; }
+  // Main loop: echo collisions since the last call
+  void on_collisions(uint32_t count) { this->collisions_ += count; }
+
+  // Main loop. Returns true when the delay changed.
+  bool recalibrate();
+
+  uint32_t samples(Direction dir) const { return this->samples_[dir]; }
+  // Compact "H bin:count,... P bin:count,..." (bin = 250 us units)
+  // Writes at most HIST_STR_MAX - 1 characters plus the terminator
+  size_t histogram_str(char *out, size_t size) const;
+  static constexpr size_t HIST_STR_MAX = 256; // Home Assistant state limit
+
+protected:
+  uint32_t hist_[DIR_COUNT][NUM_BINS]{};
+  uint32_t samples_[DIR_COUNT]{};
+
+  uint32_t panel_eof_us_{0};
+  bool gap_pending_{false};
+  bool in_frame_{false};
+  uint32_t sof_us_{0};
+  uint8_t frame_pos_{0};
+
+  volatile uint32_t errors_{0};
+  uint32_t errors_seen_{0};
+  uint32_t collisions_{0}; // main loop only
+  uint8_t clean_rounds_{0};
+
+  uint32_t default_delay_us_{MIN_DELAY_US};
+  uint32_t learned_delay_us_{0};
+  uint32_t backoff_us_{0};
+  volatile uint32_t delay_us_{MIN_DELAY_US};
+};
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,85 @@
+#include "latency_stats.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace esphome {
+namespace sauna360 {
+
+uint32_t LatencyHistogram::percentile_us(uint8_t pct) const {
+  const uint32_t total = this->count();
+  if (total == 0)
+    return 0;
+  // Rank of the percentile sample, rounded up
+  const uint32_t rank =
+      static_cast<uint32_t>((static_cast<uint64_t>(total) * pct + 99) / 100);
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < NUM_BUCKETS; b++) {
+    seen += this->buckets_[b];
+    if (seen >= rank && seen != 0) {
+      const uint32_t upper = (b == 0) ? 0 : ((1u << b) - 1);
+      return std::min(upper, this->max_us_);
+    }
+  }
+  return this->max_us_;
+}
+
+void LatencyHistogram::clear_() {
+  for (uint32_t &b : this->buckets_)
+    b = 0;
+  this->count_ = 0;
+  this->max_us_ = 0;
+  this->reset_requested_ = false;
+}
+
+void LatencyMonitor::reset() {
+  for (LatencyHistogram &h : this->stages_)
+    h.request_reset();
+}
+
+const char *LatencyMonitor::stage_name(Stage stage) {
+  switch (stage) {
+  case RX_FRAME:
+    return "rx_frame";
+  case RX_DISPATCH:
+    return "rx_dispatch";
+  case RX_PUBLISH:
+    return "rx_publish";
+  case RX_TOTAL:
+    return "rx_total";
+  case TX_ENQUEUE:
+    return "tx_enqueue";
+  case TX_WAIT:
+    return "tx_wait";
+  case TX_WRITE:
+    return "tx_write";
+  case TX_TOTAL:
+    return "tx_total";
+  default:
+    return "?";
+  }
+}
+
+size_t LatencyMonitor::format(char *out, size_t size) const {
+  if (size == 0)
+    return 0;
+  size_t pos = 0;
+  out[0] = '\0';
+  for (uint8_t s = 0; s < STAGE_COUNT && pos + 1 < size; s++) {
+    const LatencyHistogram &h = this->stages_[s];
+    if (h.count() == 0)
+      continue;
+    const int n = snprintf(out + pos, size - pos, "%s%s %u/%u/%u",
+                           pos ? " " : "", stage_name(static_cast<Stage>(s)),
+                           (unsigned)h.percentile_us(50),
+                           (unsigned)h.percentile_us(99),
+                           (unsigned)h.max_us());
+    if (n < 0)
+      break;
+    pos = std::min(size - 1, pos + static_cast<size_t>(n));
+  }
+  return pos;
+}
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sauna360 {
+
+// Fixed-bucket latency histogram. Bucket b holds values with bit length b
+// (0, 1, 2..3, 4..7, ...), so percentiles are exact to within 2x and
+// recording is a single count-leading-zeros. The exact maximum is kept.
+// Each histogram has a single writer; reset is requested by the reader and
+// carried out by the writer on its next record().
+class LatencyHistogram {
+public:
+  static constexpr uint8_t NUM_BUCKETS = 24; // last bucket: >= 4.2 s
+
+  void record(uint32_t us) {
+    if (this->reset_requested_)
+      this->clear_();
+    uint8_t b = (us == 0) ? 0 : static_cast<uint8_t>(32 - __builtin_clz(us));
+    if (b >= NUM_BUCKETS)
+      b = NUM_BUCKETS - 1;
+    this->buckets_[b]++;
+    this->count_++;
+    if (us > this->max_us_)
+      this->max_us_ = us;
+  }
+
+  void request_reset() { this->reset_requested_ = true; }
+
+  uint32_t count() const { return this->reset_requested_ ? 0 : this->count_; }
+  uint32_t max_us() const {
+    return this->reset_requested_ ? 0 : this->max_us_;
+  }
+  // Upper bound of the bucket holding the pct-th percentile (<= max)
+  uint32_t percentile_us(uint8_t pct) const;
+
+protected:
+  void clear_();
+
+  uint32_t buckets_[NUM_BUCKETS]{};
+  uint32_t count_{0};
+  uint32_t max_us_{0};
+  volatile bool reset_requested_{false};
+};
+
+// Per-stage latencies of the RX and TX pipelines, in microseconds.
+//
+//   RX: byte receipt (EOF) -> CRC validated -> dispatched -> published
+//   TX: command created -> enqueued -> bus slot granted -> written to UART
+class LatencyMonitor {
+public:
+  enum Stage : uint8_t {
+    RX_FRAME = 0, // EOF byte received -> unescaped and CRC checked
+    RX_DISPATCH,  // CRC checked -> handed to the code handler
+    RX_PUBLISH,   // handler -> listeners (entities) updated
+    RX_TOTAL,
+    TX_ENQUEUE, // command created -> frame in TX queue
+    TX_WAIT,    // queued -> panel EOF grants a bus slot
+    TX_WRITE,   // slot granted -> bytes handed to the UART driver
+    TX_TOTAL,
+    STAGE_COUNT,
+  };
+
+  void record(Stage stage, uint32_t start_us, uint32_t end_us) {
+    this->stages_[stage].record(end_us - start_us);
+  }
+  const LatencyHistogram &stage(Stage stage) const {
+    return this->stages_[stage];
+  }
+  void reset();
+
+  static const char *stage_name(Stage stage);
+  // "stage p50/p99/max ..." for every stage with samples
+  size_t format(char *out, size_t size) const;
+
+protected:
+  LatencyHistogram stages_[STAGE_COUNT];
+};
+
+} // namespace sauna360
+} // namespace esphome
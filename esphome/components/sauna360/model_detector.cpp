@@ -0,0 +1,98 @@
+#include "model_detector.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+namespace sauna360 {
+
+bool ModelDetector::on_frame(uint16_t code, uint32_t data, uint32_t now_ms) {
+  if (!this->started_) {
+    this->started_ = true;
+    this->first_ms_ = now_ms;
+  }
+
+  switch (code) {
+  case 0x6000:
+    if (this->cycles_seen_ < UINT16_MAX)
+      this->cycles_seen_++;
+    break;
+  case 0x6001:
+    // Same test as process_humidity_control()
+    this->evidence_ |= (data & 0xF0000000) == 0 ? EV_HUMIDITY_STEP
+                                                : EV_HUMIDITY_PERCENT;
+    break;
+  case 0x7280:
+    this->evidence_ |= EV_TANK;
+    break;
+  case 0x3801:
+    this->evidence_ |= EV_SENSORS;
+    break;
+  case 0x7180:
+    if (data & RELAY_LOW_BITS)
+      this->evidence_ |= EV_RELAY_LOW;
+    if (data & RELAY_HIGH_BITS)
+      this->evidence_ |= EV_RELAY_HIGH;
+    break;
+  default:
+    return false;
+  }
+
+  Model model;
+  if (!this->classify_(&model))
+    return false;
+  if (this->detected_ && model == this->model_)
+    return false;
+  this->detected_ = true;
+  this->model_ = model;
+  this->detection_ms_ = now_ms - this->first_ms_;
+  return true;
+}
+
+bool ModelDetector::classify_(Model *out) const {
+  const uint8_t ev = this->evidence_;
+  if (ev & EV_HUMIDITY_STEP) {
+    *out = Model::COMBI;
+    return true;
+  }
+  if (ev & EV_HUMIDITY_PERCENT) {
+    *out = Model::COMBI_ELITE;
+    return true;
+  }
+  if (this->cycles_seen_ < this->cycles_)
+    return false;
+  if (ev & EV_TANK)
+    *out = Model::COMBI;
+  else if (ev & (EV_SENSORS | EV_RELAY_LOW))
+    *out = Model::ELITE;
+  else
+    *out = Model::PURE;
+  return true;
+}
+
+size_t ModelDetector::evidence_str(uint8_t evidence, char *out, size_t size) {
+  static const char *const NAMES[] = {"humidity_step", "humidity_percent",
+                                      "tank",          "sensors",
+                                      "relay_low",     "relay_high"};
+  if (size == 0)
+    return 0;
+  size_t pos = 0;
+  out[0] = '\0';
+  for (uint8_t bit = 0; bit < sizeof(NAMES) / sizeof(NAMES[0]); bit++) {
+    if (!(evidence & (1 << bit)))
+      continue;
+    const int n = snprintf(out + pos, size - pos, "%s%s", pos ? "," : "",
+                           NAMES[bit]);
+    if (n < 0 || static_cast<size_t>(n) >= size - pos) {
+      out[pos] = '\0';
+      break;
+    }
+    pos += static_cast<size_t>(n);
+  }
+  if (pos == 0)
+    snprintf(out, size, "none");
+  return strlen(out);
+}
+
+} // namespace sauna360
+} // namespace esphome
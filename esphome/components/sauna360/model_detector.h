@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "model_policy.h"
+
+namespace esphome {
+namespace sauna360 {
+
+// Works out the heater model from what the heater broadcasts (model: auto).
+//
+// Fed from the RX task with every heater frame. Evidence only accumulates:
+//   0x6001 step format       COMBI, decided at once
+//   0x6001 percent format    COMBI_ELITE, decided at once
+//   0x7280 (water tank)      COMBI
+//   0x3801 (sensor frame)    ELITE
+//   0x7180 bits 0..2, 5      ELITE (light / coils of the non-PURE models)
+//   0x7180 bits 14..17       PURE
+// in that order of precedence. Apart from 0x6001 nothing is decided before
+// `cycles` heater cycles (0x6000 broadcasts) have gone by, so that registers
+// sent once per cycle have had their chance. A heater that shows none of the
+// above by then is taken to be a PURE. Later evidence with a higher
+// precedence revises the decision, so a quiet COMBI / ELITE is corrected as
+// soon as its light or coils switch on.
+class ModelDetector {
+public:
+  enum Evidence : uint8_t {
+    EV_HUMIDITY_STEP = 1 << 0,
+    EV_HUMIDITY_PERCENT = 1 << 1,
+    EV_TANK = 1 << 2,
+    EV_SENSORS = 1 << 3,
+    EV_RELAY_LOW = 1 << 4,
+    EV_RELAY_HIGH = 1 << 5,
+  };
+
+  static constexpr uint8_t DEFAULT_CYCLES = 3;
+  // TX delay until the model is known: the slowest model default
+  static constexpr uint16_t UNKNOWN_IFG_US = CombiPolicy::ifg_us;
+  static constexpr uint32_t RELAY_LOW_BITS =
+      CombiPolicy::light_mask | CombiPolicy::coils_mask;
+  static constexpr uint32_t RELAY_HIGH_BITS =
+      PurePolicy::light_mask | PurePolicy::coils_mask;
+  // "step,tank,..." for every bit set
+  static constexpr size_t EVIDENCE_STR_MAX = 64;
+
+  void set_cycles(uint8_t cycles) { this->cycles_ = cycles ? cycles : 1; }
+
+  // RX task, heater frames only. True when this frame decided the model or
+  // changed an earlier decision.
+  bool on_frame(uint16_t code, uint32_t data, uint32_t now_ms);
+
+  bool detected() const { return this->detected_; }
+  Model model() const { return this->model_; }
+  // First heater frame to the latest decision
+  uint32_t detection_ms() const { return this->detection_ms_; }
+  uint16_t cycles_seen() const { return this->cycles_seen_; }
+  uint8_t evidence() const { return this->evidence_; }
+  // True if the decision rests on nothing but the absence of evidence
+  bool by_default() const {
+    return this->detected_ && (this->evidence_ == 0);
+  }
+  static size_t evidence_str(uint8_t evidence, char *out, size_t size);
+
+protected:
+  // False while there is not enough to go on
+  bool classify_(Model *out) const;
+
+  uint8_t cycles_{DEFAULT_CYCLES};
+  uint16_t cycles_seen_{0};
+  uint8_t evidence_{0};
+  bool started_{false};
+  uint32_t first_ms_{0};
+
+  bool detected_{false};
+  Model model_{Model::PURE};
+  uint32_t detection_ms_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+
+#include "esphome/core/defines.h"
+
+namespace esphome {
+namespace sauna360 {
+
+enum class Model : uint8_t { PURE = 0, COMBI = 1, ELITE = 2, COMBI_ELITE = 3 };
+
+// How 0x6001 is used by the model
+enum class HumidityMode : uint8_t { NONE = 0, STEP = 1, PERCENT = 2 };
+
+// Per-model constants. Codegen defines SAUNA360_MODEL_<NAME> for a fixed
+// `model:`, which makes ModelPolicy one of the structs below: every field
+// is a constant, and handlers the model cannot use drop out of the build.
+// Without a define ModelPolicy is RuntimeModelPolicy, which holds the same
+// fields as members and can be switched at runtime.
+struct PurePolicy {
+  static constexpr bool FIXED = true;
+  static constexpr Model model = Model::PURE;
+  static constexpr uint32_t light_mask = 0x00020000; // bit 17
+  static constexpr uint32_t coils_mask = 0x0001C000; // bits 16..14
+  static constexpr uint8_t coils_shift = 14;
+  static constexpr uint16_t ifg_us = 520;
+  static constexpr HumidityMode humidity = HumidityMode::NONE;
+  static constexpr bool water_tank = false;
+  static constexpr bool aux_relays = false;
+};
+
+struct CombiPolicy {
+  static constexpr bool FIXED = true;
+  static constexpr Model model = Model::COMBI;
+  static constexpr uint32_t light_mask = 0x00000020; // bit 5
+  static constexpr uint32_t coils_mask = 0x00000007; // bits 2..0
+  static constexpr uint8_t coils_shift = 0;
+  static constexpr uint16_t ifg_us = 7000;
+  static constexpr HumidityMode humidity = HumidityMode::STEP;
+  static constexpr bool water_tank = true;
+  static constexpr bool aux_relays = true;
+};
+
+struct ElitePolicy {
+  static constexpr bool FIXED = true;
+  static constexpr Model model = Model::ELITE;
+  static constexpr uint32_t light_mask = 0x00000020;
+  static constexpr uint32_t coils_mask = 0x00000007;
+  static constexpr uint8_t coils_shift = 0;
+  static constexpr uint16_t ifg_us = 7000;
+  static constexpr HumidityMode humidity = HumidityMode::NONE;
+  static constexpr bool water_tank = false;
+  static constexpr bool aux_relays = true;
+};
+
+struct CombiElitePolicy {
+  static constexpr bool FIXED = true;
+  static constexpr Model model = Model::COMBI_ELITE;
+  static constexpr uint32_t light_mask = 0x00000020;
+  static constexpr uint32_t coils_mask = 0x00000007;
+  static constexpr uint8_t coils_shift = 0;
+  static constexpr uint16_t ifg_us = 7000;
+  static constexpr HumidityMode humidity = HumidityMode::PERCENT;
+  static constexpr bool water_tank = true;
+  static constexpr bool aux_relays = false;
+};
+
+struct RuntimeModelPolicy {
+  static constexpr bool FIXED = false;
+  Model model{Model::PURE};
+  uint32_t light_mask{PurePolicy::light_mask};
+  uint32_t coils_mask{PurePolicy::coils_mask};
+  uint8_t coils_shift{PurePolicy::coils_shift};
+  uint16_t ifg_us{PurePolicy::ifg_us};
+  HumidityMode humidity{PurePolicy::humidity};
+  bool water_tank{PurePolicy::water_tank};
+  bool aux_relays{PurePolicy::aux_relays};
+
+  template <typename P> void assign() {
+    this->model = P::model;
+    this->light_mask = P::light_mask;
+    this->coils_mask = P::coils_mask;
+    this->coils_shift = P::coils_shift;
+    this->ifg_us = P::ifg_us;
+    this->humidity = P::humidity;
+    this->water_tank = P::water_tank;
+    this->aux_relays = P::aux_relays;
+  }
+  void select(Model m) {
+    switch (m) {
+    case Model::COMBI:
+      this->assign<CombiPolicy>();
+      break;
+    case Model::ELITE:
+      this->assign<ElitePolicy>();
+      break;
+    case Model::COMBI_ELITE:
+      this->assign<CombiElitePolicy>();
+      break;
+    default:
+      this->assign<PurePolicy>();
+      break;
+    }
+  }
+};
+
+#if defined(SAUNA360_MODEL_PURE)
+#define SAUNA360_MODEL_FIXED
+using ModelPolicy = PurePolicy;
+#elif defined(SAUNA360_MODEL_COMBI)
+#define SAUNA360_MODEL_FIXED
+using ModelPolicy = CombiPolicy;
+#elif defined(SAUNA360_MODEL_ELITE)
+#define SAUNA360_MODEL_FIXED
+using ModelPolicy = ElitePolicy;
+#elif defined(SAUNA360_MODEL_COMBI_ELITE)
+#define SAUNA360_MODEL_FIXED
+using ModelPolicy = CombiElitePolicy;
+#else
+using ModelPolicy = RuntimeModelPolicy;
+#endif
+
+inline const char *model_name(Model m) {
+  switch (m) {
+  case Model::PURE:
+    return "PURE";
+  case Model::COMBI:
+    return "COMBI";
+  case Model::ELITE:
+    return "ELITE";
+  case Model::COMBI_ELITE:
+    return "COMBI_ELITE";
+  default:
+    return "UNKNOWN";
+  }
+}
+
+} // namespace sauna360
+} // namespace esphome
@@ -11,7 +11,14 @@ from esphome.const import (
     DEVICE_CLASS_TEMPERATURE,
 )
 
-from .. import sauna360_ns, SAUNA360Component, CONF_SAUNA360_ID
+from .. import (
+    sauna360_ns,
+    SAUNA360Component,
+    CONF_SAUNA360_ID,
+    FEATURE_HUMIDITY_PERCENT,
+    FEATURE_HUMIDITY_STEP,
+    model_feature_validator,
+)
 
 SAUNA360BathTimeNumber = sauna360_ns.class_("SAUNA360BathTimeNumber", number.Number)
 SAUNA360BathTemperatureNumber = sauna360_ns.class_(
@@ -153,6 +160,13 @@ CONFIG_SCHEMA = cv.Schema(
     }
 )
 
+FINAL_VALIDATE_SCHEMA = model_feature_validator(
+    {
+        CONF_HUMIDITY_STEP: FEATURE_HUMIDITY_STEP,
+        CONF_HUMIDITY_PERCENT: FEATURE_HUMIDITY_PERCENT,
+    }
+)
+
 
 async def to_code(config):
     sauna360_component = await cg.get_variable(config[CONF_SAUNA360_ID])
@@ -0,0 +1,182 @@
+#include "power_manager.h"
+#include "esphome/core/log.h"
+
+#ifndef USE_HOST
+#include "driver/uart.h"
+#include "esp_private/esp_clk.h"
+#include "esp_sleep.h"
+#endif
+
+namespace esphome {
+namespace sauna360 {
+
+static const char *const TAG = "sauna360.pm";
+
+volatile uint32_t PowerManager::wake_count_ = 0;
+
+#ifdef CONFIG_PM_ENABLE
+esp_err_t IRAM_ATTR PowerManager::on_light_sleep_exit_(int64_t, void *) {
+  wake_count_ = wake_count_ + 1;
+  return ESP_OK;
+}
+
+void PowerManager::on_wake_timer_(void *arg) {
+  static_cast<PowerManager *>(arg)->hold_sleep_lock_();
+}
+
+void PowerManager::hold_sleep_lock_() {
+  if (!this->sleep_lock_held_.exchange(true))
+    esp_pm_lock_acquire(this->sleep_lock_);
+}
+#endif
+
+bool PowerManager::setup(int uart_port) {
+#ifdef CONFIG_PM_ENABLE
+  esp_pm_config_t cfg = {};
+  cfg.max_freq_mhz = CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ;
+  cfg.min_freq_mhz = this->min_freq_mhz_;
+  cfg.light_sleep_enable = this->light_sleep_;
+  esp_err_t err = esp_pm_configure(&cfg);
+  if (err != ESP_OK) {
+    ESP_LOGW(TAG, "esp_pm_configure failed: %s", esp_err_to_name(err));
+    return false;
+  }
+
+  esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "sauna_active", &this->cpu_lock_);
+  esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "sauna_frame", &this->frame_lock_);
+  esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "sauna_bus", &this->sleep_lock_);
+
+  if (this->light_sleep_) {
+    // The edges that wake the chip are consumed by the wake-up logic, so a
+    // UART wake-up cuts the frame that caused it (counted as dropped). The
+    // wake timer is there so that this only happens when a burst comes
+    // earlier than predicted or after the bus was down.
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback = on_wake_timer_;
+    timer_args.arg = this;
+    timer_args.name = "sauna_wake";
+    esp_timer_create(&timer_args, &this->wake_timer_);
+    uart_set_wakeup_threshold(static_cast<uart_port_t>(uart_port), 3);
+    esp_sleep_enable_uart_wakeup(uart_port);
+#ifdef CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs = {};
+    cbs.exit_cb = on_light_sleep_exit_;
+    esp_pm_light_sleep_register_cbs(&cbs);
+#endif
+    esp_pm_lock_acquire(this->sleep_lock_);
+    this->sleep_lock_held_.store(true);
+  }
+
+  this->enabled_ = true;
+  this->set_active(true);
+  ESP_LOGI(TAG, "Power management: DFS %u..%u MHz, light sleep %s",
+           (unsigned)this->min_freq_mhz_,
+           (unsigned)CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ,
+           this->light_sleep_ ? "on" : "off");
+  return true;
+#else
+  ESP_LOGW(TAG, "CONFIG_PM_ENABLE not set, power management disabled");
+  return false;
+#endif
+}
+
+void PowerManager::on_byte(uint8_t b, uint32_t now_ms) {
+  if (!this->enabled_)
+    return;
+  if (now_ms - this->last_byte_ms_ > BURST_GAP_MS) {
+    const uint32_t period = now_ms - this->burst_start_ms_;
+    const uint32_t learned = this->period_ms_;
+    const uint32_t diff = period > learned ? period - learned : learned - period;
+    if (this->burst_start_ms_ == 0 || period < MIN_PERIOD_MS ||
+        period > MAX_PERIOD_MS) {
+      this->period_ms_ = 0;
+      this->stable_bursts_ = 0;
+    } else if (learned == 0 || diff > learned / 4) {
+      this->period_ms_ = period;
+      this->stable_bursts_ = 1;
+    } else {
+      this->period_ms_ = (learned * 3 + period) / 4;
+      if (this->stable_bursts_ < LOCK_BURSTS)
+        this->stable_bursts_ = this->stable_bursts_ + 1;
+    }
+    this->burst_start_ms_ = now_ms;
+  }
+  this->last_byte_ms_ = now_ms;
+#ifdef CONFIG_PM_ENABLE
+  if (this->light_sleep_)
+    this->hold_sleep_lock_();
+  // Full clock while a frame is on the wire
+  if (b == 0x98 && !this->frame_lock_held_) {
+    esp_pm_lock_acquire(this->frame_lock_);
+    this->frame_lock_held_ = true;
+  } else if (b == 0x9C && this->frame_lock_held_) {
+    esp_pm_lock_release(this->frame_lock_);
+    this->frame_lock_held_ = false;
+  }
+#endif
+}
+
+void PowerManager::set_active(bool active) {
+  if (!this->enabled_ || active == this->active_)
+    return;
+  this->active_ = active;
+#ifdef CONFIG_PM_ENABLE
+  if (active)
+    esp_pm_lock_acquire(this->cpu_lock_);
+  else
+    esp_pm_lock_release(this->cpu_lock_);
+#endif
+  ESP_LOGD(TAG, "%s mode", active ? "Active" : "Idle");
+}
+
+void PowerManager::loop(uint32_t now_ms) {
+  if (!this->enabled_)
+    return;
+
+  if ((now_ms - this->last_sample_ms_) >= 100u) {
+    this->last_sample_ms_ = now_ms;
+#ifndef USE_HOST
+    this->freq_sum_mhz_ += esp_clk_cpu_freq() / 1000000;
+#endif
+    this->freq_samples_++;
+  }
+
+#ifdef CONFIG_PM_ENABLE
+  if (!this->light_sleep_ || this->active_ || !this->sleep_lock_held_.load())
+    return;
+  const uint32_t quiet = now_ms - this->last_byte_ms_;
+  if (quiet > BUS_DOWN_MS) {
+    // Bus down: sleep until UART activity
+    if (this->sleep_lock_held_.exchange(false))
+      esp_pm_lock_release(this->sleep_lock_);
+    return;
+  }
+  const uint32_t period = this->period_ms_;
+  if (this->stable_bursts_ < LOCK_BURSTS || quiet < this->quiet_ms_)
+    return;
+  // Sleep between bursts, up to WAKE_GUARD_MS before the next one
+  const int32_t sleep_ms = static_cast<int32_t>(
+      this->burst_start_ms_ + period - WAKE_GUARD_MS - now_ms);
+  if (sleep_ms < static_cast<int32_t>(MIN_SLEEP_MS))
+    return;
+  esp_timer_stop(this->wake_timer_);
+  if (esp_timer_start_once(this->wake_timer_,
+                           static_cast<uint64_t>(sleep_ms) * 1000) != ESP_OK)
+    return;
+  if (this->sleep_lock_held_.exchange(false))
+    esp_pm_lock_release(this->sleep_lock_);
+#endif
+}
+
+uint32_t PowerManager::take_avg_cpu_freq_mhz() {
+  if (this->freq_samples_ == 0)
+    return 0;
+  const uint32_t avg =
+      static_cast<uint32_t>(this->freq_sum_mhz_ / this->freq_samples_);
+  this->freq_sum_mhz_ = 0;
+  this->freq_samples_ = 0;
+  return avg;
+}
+
+} // namespace sauna360
+} // namespace esphome
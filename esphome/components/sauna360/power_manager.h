@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "esphome/core/defines.h"
+
+#ifndef USE_HOST
+#include "sdkconfig.h"
+#endif
+#ifdef CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#include "esp_timer.h"
+#endif
+
+namespace esphome {
+namespace sauna360 {
+
+// Idle-mode power management for the RS485 link.
+//
+// While a session is active (or TX / a profile is pending) the CPU is held
+// at maximum frequency. When idle, the CPU_FREQ_MAX lock is only taken while
+// a frame is on the wire, so DFS can drop the clock between frames.
+//
+// Light sleep (heater idle only): the heater talks in bursts, one per bus
+// cycle. The RX task learns the burst period; once LOCK_BURSTS periods in a
+// row agree within a quarter and a burst has been quiet
+// for quiet_ms and the next one is predicted far enough ahead, the
+// NO_LIGHT_SLEEP lock is released and a timer takes it back WAKE_GUARD_MS
+// before that burst, so the UART is awake when it starts. Without a learned
+// period the chip only sleeps once the bus has been silent for BUS_DOWN_MS
+// and wakes on UART activity.
+class PowerManager {
+public:
+  // Longer gaps than this between two bytes start a new burst
+  static constexpr uint32_t BURST_GAP_MS = 50;
+  // Plausible burst periods; anything else drops the prediction
+  static constexpr uint32_t MIN_PERIOD_MS = 200;
+  static constexpr uint32_t MAX_PERIOD_MS = 10000;
+  static constexpr uint8_t LOCK_BURSTS = 3;
+  // Awake this long before the predicted burst
+  static constexpr uint32_t WAKE_GUARD_MS = 20;
+  // Shorter sleeps are not worth the wake-up
+  static constexpr uint32_t MIN_SLEEP_MS = 50;
+  static constexpr uint32_t BUS_DOWN_MS = 5000;
+
+  void set_min_freq_mhz(uint16_t mhz) { this->min_freq_mhz_ = mhz; }
+  void set_light_sleep(bool enable) { this->light_sleep_ = enable; }
+  void set_quiet_ms(uint32_t ms) { this->quiet_ms_ = ms; }
+  bool light_sleep() const { return this->light_sleep_; }
+
+  bool setup(int uart_port);
+
+  // RX task
+  void on_byte(uint8_t b, uint32_t now_ms);
+
+  // Main loop
+  void set_active(bool active);
+  void loop(uint32_t now_ms);
+
+  bool is_active() const { return this->active_; }
+  uint32_t wake_count() const { return this->wake_count_; }
+  // Mean of the CPU frequency samples since the last call
+  uint32_t take_avg_cpu_freq_mhz();
+
+protected:
+  uint16_t min_freq_mhz_{80};
+  bool light_sleep_{false};
+  uint32_t quiet_ms_{100};
+  bool enabled_{false};
+  bool active_{false};
+
+  // RX task state
+  bool frame_lock_held_{false};
+  std::atomic<bool> sleep_lock_held_{false};
+  volatile uint32_t last_byte_ms_{0};
+  volatile uint32_t burst_start_ms_{0};
+  volatile uint32_t period_ms_{0}; // learned burst period, 0 = unknown
+  volatile uint8_t stable_bursts_{0};
+
+  uint32_t last_sample_ms_{0};
+  uint64_t freq_sum_mhz_{0};
+  uint32_t freq_samples_{0};
+
+  static volatile uint32_t wake_count_;
+
+#ifdef CONFIG_PM_ENABLE
+  static esp_err_t on_light_sleep_exit_(int64_t sleep_time_us, void *arg);
+  static void on_wake_timer_(void *arg);
+  void hold_sleep_lock_();
+
+  esp_pm_lock_handle_t cpu_lock_{nullptr};
+  esp_pm_lock_handle_t frame_lock_{nullptr};
+  esp_pm_lock_handle_t sleep_lock_{nullptr};
+  esp_timer_handle_t wake_timer_{nullptr};
+#endif
+};
+
+} // namespace sauna360
+} // namespace esphome
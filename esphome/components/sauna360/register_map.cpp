@@ -0,0 +1,40 @@
+#include "register_map.h"
+
+namespace esphome {
+namespace sauna360 {
+
+const RegisterMap::Entry *RegisterMap::update(Direction dir, uint16_t code,
+                                              uint32_t value,
+                                              uint32_t now_ms) {
+  const uint32_t key = (static_cast<uint32_t>(dir) << 16) | code;
+  uint16_t i = hash_(key);
+  for (uint16_t probe = 0; probe < CAPACITY; probe++) {
+    Entry &e = this->entries_[i];
+    if (e.key == key) {
+      const uint32_t diff = e.value ^ value;
+      if (diff != 0) {
+        e.changed_bits |= diff;
+        e.changes++;
+        e.value = value;
+      }
+      e.frames++;
+      e.last_ms = now_ms;
+      return &e;
+    }
+    if (e.key == EMPTY_KEY) {
+      e.key = key;
+      e.value = value;
+      e.frames = 1;
+      e.first_ms = now_ms;
+      e.last_ms = now_ms;
+      this->size_++;
+      return &e;
+    }
+    i = (i + 1) & (CAPACITY - 1);
+  }
+  this->dropped_++;
+  return nullptr;
+}
+
+} // namespace sauna360
+} // namespace esphome
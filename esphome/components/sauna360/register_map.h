@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sauna360 {
+
+// Shadow copy of every (direction, code) register seen on the bus.
+// Fixed-capacity open addressing with linear probing: one hash and a short
+// probe per frame, no allocation after construction.
+class RegisterMap {
+public:
+  enum Direction : uint8_t { HEATER_TO_PANEL = 0, PANEL_TO_HEATER = 1 };
+
+  static constexpr uint16_t CAPACITY = 128; // power of two
+  static constexpr uint32_t EMPTY_KEY = 0xFFFFFFFF;
+
+  struct Entry {
+    uint32_t key{EMPTY_KEY}; // (direction << 16) | code
+    uint32_t value{0};
+    uint32_t changed_bits{0}; // OR of all bits that ever toggled
+    uint32_t frames{0};
+    uint32_t changes{0};
+    uint32_t first_ms{0};
+    uint32_t last_ms{0};
+
+    Direction direction() const { return static_cast<Direction>(key >> 16); }
+    uint16_t code() const { return static_cast<uint16_t>(key & 0xFFFF); }
+  };
+
+  // Returns the updated entry, or nullptr when the table is full.
+  const Entry *update(Direction dir, uint16_t code, uint32_t value,
+                      uint32_t now_ms);
+
+  uint16_t size() const { return this->size_; }
+  uint32_t dropped() const { return this->dropped_; }
+  const Entry &slot(uint16_t i) const { return this->entries_[i]; }
+
+protected:
+  static uint16_t hash_(uint32_t key) {
+    return static_cast<uint16_t>((key * 2654435761u) >> 16) & (CAPACITY - 1);
+  }
+
+  Entry entries_[CAPACITY];
+  uint16_t size_{0};
+  uint32_t dropped_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
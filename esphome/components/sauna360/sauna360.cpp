@@ -1,7 +1,9 @@
 #include "sauna360.h"
 #include "esphome/components/number/number.h"
+#ifndef USE_HOST
 #include "esphome/components/uart/uart.h"
 #include "esphome/components/uart/uart_component.h"
+#endif
 #include "esphome/core/application.h"
 #include "esphome/core/automation.h"
 #include "esphome/core/component.h"
@@ -10,57 +12,36 @@
 #include "esphome/core/preferences.h"
 #include "esphome/core/time.h"
 
-#include "driver/uart.h"
-#include "esp_rom_sys.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
-#include "freertos/task.h"
-#include "sdkconfig.h"
+#include <cstring>
+#include <ctime>
 
 namespace esphome {
 namespace sauna360 {
 
 static const char *TAG = "sauna360";
+static const char *const STATE_BLOCKED =
+    "Operation blocked by not allowed start";
 
-void SAUNA360Component::setup() {
-  this->min_ifg_us_ = (this->mode_ == Mode::PURE) ? 520 : 7000;
 
-  const char *mode_str = nullptr;
-  switch (this->mode_) {
-  case Mode::PURE:
-    mode_str = "PURE";
-    break;
-  case Mode::COMBI:
-    mode_str = "COMBI";
-    break;
-  case Mode::ELITE:
-    mode_str = "ELITE";
-    break;
-  case Mode::COMBI_ELITE:
-    mode_str = "COMBI_ELITE";
-    break;
-  default:
-    mode_str = "PURE";
-    break;
-  }
+void SAUNA360Component::setup() {
+  this->min_ifg_us_ = this->model_.ifg_us;
+  const char *mode_str = model_name(this->model_.model);
+#ifdef SAUNA360_MODEL_AUTO
+  // Until the heater gives its model away: the slow delay every model
+  // tolerates, and 0x7180 is not decoded
+  this->min_ifg_us_ = ModelDetector::UNKNOWN_IFG_US;
+  mode_str = "auto, detecting";
+#endif
 
-  ESP_LOGI(TAG, "IFG selected: %d us (%s)", this->min_ifg_us_, mode_str);
+  ESP_LOGI(TAG, "IFG selected: %d us (%s)%s", this->min_ifg_us_, mode_str,
+           this->adaptive_ifg_ ? ", adaptive" : "");
+  this->ifg_.set_default_delay_us(this->min_ifg_us_);
 
-  // Model-specific bitmasks
-  // PURE
-  if (this->mode_ == Mode::PURE) {
-    this->LIGHT_MASK_ = 0x00020000; // bit 17
-    this->COILS_MASK_ = 0x0001C000; // bits 16..14
-    this->COILS_SHIFT_ = 14;
-    // COMBI, ELITE, COMBI_ELITE
-  } else {
-    this->LIGHT_MASK_ = 0x00000020; // bit 5
-    this->COILS_MASK_ = 0x00000007; // bits 2..0
-    this->COILS_SHIFT_ = 0;
-  }
+#ifndef SAUNA360_MODEL_AUTO
   ESP_LOGI(TAG, "Relay bitmasks: LIGHT=0x%08X COILS=0x%08X (shift=%d)",
-           (unsigned)this->LIGHT_MASK_, (unsigned)this->COILS_MASK_,
-           this->COILS_SHIFT_);
+           (unsigned)this->model_.light_mask, (unsigned)this->model_.coils_mask,
+           (int)this->model_.coils_shift);
+#endif
 
   // Initial UI state
   if (this->light_relay_switch_ != nullptr)
@@ -69,59 +50,83 @@ void SAUNA360Component::setup() {
     this->heater_relay_switch_->publish_state(false);
   if (this->bath_temperature_number_ != nullptr)
     this->bath_temperature_number_->publish_state(0.0f);
-  for (auto &l : listeners_)
-    l->on_ready_status(true);
+  // Ready / availability are published once the first valid frame arrives
 
-  // Keep UART hot
+  // Keep UART hot; with power save only while the sauna is in use
+  if (!this->power_save_ || !this->pm_.setup(BusPort::UART_PORT))
+    this->power_save_ = false;
   this->high_freq_.start();
 
-  // UART low-latency
-  static constexpr uart_port_t PORT = UART_NUM_0;
-  uart_set_rx_full_threshold(PORT, 1);
-  uart_set_rx_timeout(PORT, 1);
-
-  TaskHandle_t rx_task = nullptr;
-#if CONFIG_FREERTOS_UNICORE
-  const BaseType_t core_id = 0;
-#else
-  const BaseType_t core_id = 1;
+#ifdef SAUNA360_CUSTOM_REGISTERS
+  this->custom_.finalize();
+#endif
+#ifdef SAUNA360_FRAME_STREAM
+  this->stream_.start();
+#endif
+#ifdef SAUNA360_JOURNAL
+  this->journal_.setup();
+#endif
+#ifdef SAUNA360_FLIGHT_RECORDER
+  this->recorder_.setup();
 #endif
 
   // RX/flow-control task
-  xTaskCreatePinnedToCore(
+  const bool started = this->bus_.start(
       [](void *ctx) {
         auto *self = static_cast<SAUNA360Component *>(ctx);
-        static constexpr uart_port_t PORT = UART_NUM_0;
 
-        uint8_t b = 0, w0 = 0, w1 = 0, w2 = 0, w3 = 0, w4 = 0, w5 = 0;
+        uint8_t w0 = 0, w1 = 0, w2 = 0, w3 = 0, w4 = 0, w5 = 0;
 
         for (;;) {
-          int n = uart_read_bytes(PORT, &b, 1, portMAX_DELAY);
-          if (n != 1)
+#ifdef SAUNA360_BENCHMARK
+          if (self->bench_.pending())
+            self->run_benchmark_();
+#endif
+          // One byte, or a whole frame with rx_dma
+          const uint8_t *buf = nullptr;
+          uint32_t now_us = 0;
+          const size_t len = self->bus_.read(&buf, &now_us);
+#ifdef SAUNA360_RX_DMA
+          if (self->handle_dma_frame_(buf, len, now_us))
             continue;
-
-          // Detect panel EOF: 98 40 07 FD E3 9C
-          w0 = w1;
-          w1 = w2;
-          w2 = w3;
-          w3 = w4;
-          w4 = w5;
-          w5 = b;
-          const bool panel_eof = (w0 == 0x98 && w1 == 0x40 && w2 == 0x07 &&
-                                  w3 == 0xFD && w4 == 0xE3 && w5 == 0x9C);
-
-          if (panel_eof && !self->tx_queue_.empty()) {
-            esp_rom_delay_us(self->min_ifg_us_);
-            size_t rx_avail = 0;
-            (void)uart_get_buffered_data_len(PORT, &rx_avail);
-            if (rx_avail == 0)
-              self->send_data_();
+#endif
+          for (size_t i = 0; i < len; i++) {
+            const uint8_t b = buf[i];
+            if (self->power_save_)
+              self->pm_.on_byte(b, millis());
+
+            // Detect panel EOF (98 40 07 FD E3 9C) and heater poll
+            // (98 40 06 6D 3A 9C)
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = w4;
+            w4 = w5;
+            w5 = b;
+            const bool panel_eof = (w0 == 0x98 && w1 == 0x40 && w2 == 0x07 &&
+                                    w3 == 0xFD && w4 == 0xE3 && w5 == 0x9C);
+            const bool heater_poll = (w0 == 0x98 && w1 == 0x40 &&
+                                      w2 == 0x06 && w3 == 0x6D &&
+                                      w4 == 0x3A && w5 == 0x9C);
+
+            if (!self->virtual_panel_ && self->adaptive_ifg_)
+              self->ifg_.on_byte(b, now_us, panel_eof);
+            if (panel_eof || heater_poll)
+              self->handle_slot_(panel_eof, i + 1 < len, now_us);
+
+            self->rx_byte_us_ = now_us;
+            self->handle_byte_(b);
           }
-
-          self->handle_byte_(b);
         }
       },
-      "sauna_rx_fast", 4096, this, configMAX_PRIORITIES - 3, &rx_task, core_id);
+      this);
+  if (!started) {
+    this->mark_failed();
+    return;
+  }
+#ifdef SAUNA360_HEAP_AUDIT
+  heap_audit::set_rx_task(this->bus_.rx_task());
+#endif
 
   if (!this->defaults_initialized_) {
     this->initialize_defaults();
@@ -130,125 +135,441 @@ void SAUNA360Component::setup() {
 }
 
 void SAUNA360Component::loop() {
+#ifdef SAUNA360_HEAP_AUDIT
+  heap_audit::LoopScope audit_scope;
+#endif
   const uint32_t now = millis();
+  this->check_bus_watchdog_(now);
+  if (this->anomaly_enabled_)
+    this->publish_anomalies_();
+#ifdef SAUNA360_MODEL_AUTO
+  if (this->model_changed_)
+    this->model_loop_();
+#endif
+#ifdef SAUNA360_CYCLE_LEARNER
+  if (this->cycles_.lock_count() != this->cycle_lock_logged_) {
+    this->cycle_lock_logged_ = this->cycles_.lock_count();
+    ESP_LOGI(TAG, "Bus cycle learned: %u events, %u TX windows, period %u ms",
+             (unsigned)this->cycles_.events(),
+             (unsigned)this->cycles_.windows(),
+             (unsigned)(this->cycles_.period_us() / 1000u));
+  }
+#endif
+#ifdef SAUNA360_JOURNAL
+  this->journal_loop_();
+#endif
+#ifdef SAUNA360_FLIGHT_RECORDER
+  this->recorder_loop_();
+#endif
+#ifdef SAUNA360_BENCHMARK
+  this->benchmark_loop_();
+#endif
+  if (this->foreign_panel_ && !this->foreign_panel_logged_) {
+    this->foreign_panel_logged_ = true;
+    ESP_LOGE(TAG, "Physical panel detected on the bus, virtual panel "
+                  "disabled; commands now wait for the panel's slot");
+  }
+  if (this->power_save_)
+    this->update_power_state_(now);
+  if ((now - this->last_diag_pub_ms_) >= DIAG_PUBLISH_INTERVAL_MS) {
+    this->last_diag_pub_ms_ = now;
+    this->publish_diagnostics_();
+  }
+
   if ((now - this->last_session_pub_ms_) >= 1000u) {
     if (this->session_active_) {
       this->publish_session_();
     }
     this->last_session_pub_ms_ = now;
   }
-}
 
-void SAUNA360Component::handle_byte_(uint8_t c) {
-  if (c == 0x98) {
-    this->frame_flag_ = true;
+  if (this->pending_profile_ != nullptr)
+    this->check_profile_confirmed_(now);
+
+  if (this->adaptive_ifg_ &&
+      (now - this->last_ifg_eval_ms_) >= IFG_EVAL_INTERVAL_MS) {
+    this->last_ifg_eval_ms_ = now;
+    const uint32_t collisions = this->arbiter_.collisions();
+    this->ifg_.on_collisions(collisions - this->ifg_collisions_seen_);
+    this->ifg_collisions_seen_ = collisions;
+    if (this->ifg_.recalibrate()) {
+      this->min_ifg_us_ = static_cast<int>(this->ifg_.delay_us());
+      ESP_LOGI(TAG, "IFG recalibrated: %d us (samples H=%u P=%u)",
+               this->min_ifg_us_,
+               (unsigned)this->ifg_.samples(IFGCalibrator::DIR_HEATER),
+               (unsigned)this->ifg_.samples(IFGCalibrator::DIR_PANEL));
+    }
+    char hist[IFGCalibrator::HIST_STR_MAX];
+    this->ifg_.histogram_str(hist, sizeof(hist));
+    for (auto &listener : listeners_) {
+      listener->on_tx_delay(static_cast<uint32_t>(this->min_ifg_us_));
+      listener->on_ifg_histogram(hist);
+    }
   }
-  if (c == 0x98 && this->frame_flag_ == true) {
-    this->rx_message_.clear();
+}
+
+// RX task: a panel EOF (`panel_eof`) or a heater poll ended at `end_us`.
+// `more` means other bytes already followed it, so the slot is taken.
+void SAUNA360Component::handle_slot_(bool panel_eof, bool more,
+                                     uint32_t end_us) {
+#ifdef SAUNA360_CYCLE_LEARNER
+  this->cycles_.on_event(panel_eof ? CycleLearner::KEY_WINDOW
+                                   : CycleLearner::KEY_POLL,
+                         end_us);
+#endif
+  if (this->tx_flush_.exchange(false, std::memory_order_acquire))
+    this->tx_head_.store(this->tx_tail_.load(std::memory_order_acquire),
+                         std::memory_order_release);
+  if (this->virtual_panel_) {
+    // A panel EOF we did not send means a physical panel is on the bus;
+    // step back
+    if (panel_eof && (end_us - this->last_tx_us_) > OWN_ECHO_WINDOW_US) {
+      this->virtual_panel_ = false;
+      this->foreign_panel_ = true;
+    } else if (!panel_eof && !more) {
+      this->answer_poll_(end_us);
+    }
   }
-  if (c == 0x9C) {
-    this->rx_message_.push_back(c);
-    std::vector<uint8_t> frame(this->rx_message_.begin(),
-                               this->rx_message_.end());
-    size_t len = frame.size();
-    if (len > 6) {
-      this->handle_frame_(frame);
+
+  if (panel_eof && !this->virtual_panel_ && this->tx_pending_() &&
+      this->arbiter_.may_transmit(end_us)) {
+#ifdef SAUNA360_CYCLE_LEARNER
+    // Too short for the batch; a later window of the cycle is not
+    if (!more && this->cycles_.should_defer(this->head_batch_airtime_us_()))
+      return;
+#endif
+    // Higher node IDs wait longer and give way to lower ones
+    if (!more)
+      BusPort::wait_after(end_us, this->min_ifg_us_ +
+                                      this->arbiter_.slot_offset_us());
+    if (!more && this->bus_.available() == 0) {
+      this->send_data_(end_us);
+    } else {
+      this->arbiter_.on_deferred();
     }
-    this->rx_message_.clear();
-    this->frame_flag_ = false;
-    return;
   }
-  if (this->frame_flag_ == true) {
-    this->rx_message_.push_back(c);
+}
+
+#ifdef SAUNA360_RX_DMA
+// RX task: a DMA buffer holding exactly one frame is decoded where it lies,
+// without the byte loop or the copy into rx_buf_. False for anything else
+// (partial or merged frames, noise), which takes the byte path.
+bool SAUNA360Component::handle_dma_frame_(const uint8_t *buf, size_t len,
+                                          uint32_t end_us) {
+  if (len < 6 || len > RX_BUF_LEN || buf[0] != 0x98 || buf[len - 1] != 0x9C ||
+      this->frame_flag_ || memchr(buf + 1, 0x98, len - 2) != nullptr)
+    return false;
+  // Nothing to clock up for: the frame arrived without the CPU
+  if (this->power_save_)
+    this->pm_.on_byte(0x9C, millis());
+  if (len == 6) {
+    const bool panel_eof = memcmp(buf, protocol::PANEL_ACK, 6) == 0;
+    if (panel_eof || memcmp(buf, protocol::HEATER_POLL, 6) == 0)
+      this->handle_slot_(panel_eof, false, end_us);
   }
+  this->rx_byte_us_ = end_us;
+  this->handle_rx_frame_(buf, len);
+  return true;
 }
+#endif
 
-void SAUNA360Component::handle_frame_(const std::vector<uint8_t> &frame) {
-  std::vector<uint8_t> packet;
-  bool is_escaped = false;
+// Virtual panel, RX task: reply in the panel's slot after a heater poll.
+// Like the real panel, a pending command replaces the plain ack.
+void SAUNA360Component::answer_poll_(uint32_t poll_us) {
+  BusPort::wait_after(poll_us, VIRTUAL_PANEL_REPLY_US);
+  if (this->bus_.available() != 0)
+    return; // someone else is talking
+  if (this->tx_pending_()) {
+    this->send_data_(poll_us);
+  } else {
+    this->bus_.write(protocol::PANEL_ACK, sizeof(protocol::PANEL_ACK));
+    this->capture_(protocol::PANEL_ACK, sizeof(protocol::PANEL_ACK),
+                   protocol::REC_VALID | protocol::REC_PANEL | protocol::REC_TX,
+                   micros());
+  }
+  this->last_tx_us_ = micros();
+}
 
-  for (size_t i = 1; i < frame.size() - 1; ++i) {
-    uint8_t data = frame[i];
+void SAUNA360Component::publish_anomalies_() {
+  AnomalyDetector::Reason reason;
+  char detail[AnomalyDetector::DETAIL_MAX];
+  while (this->anomaly_.poll(&reason, detail, sizeof(detail))) {
+    ESP_LOGW(TAG, "Anomaly %s: %s", AnomalyDetector::reason_name(reason),
+             detail);
+    for (auto &listener : listeners_)
+      listener->on_anomaly(reason, detail);
+  }
+}
 
-    if (data == 0x91) {
-      is_escaped = true;
-      continue;
-    }
+#ifdef SAUNA360_MODEL_AUTO
+void SAUNA360Component::model_loop_() {
+  this->model_changed_ = false;
+  const Model model = this->detector_.model();
+  const uint32_t ms = this->detector_.detection_ms();
+  char evidence[ModelDetector::EVIDENCE_STR_MAX];
+  ModelDetector::evidence_str(this->detector_.evidence(), evidence,
+                              sizeof(evidence));
+
+  this->ifg_.set_default_delay_us(this->model_.ifg_us);
+  this->min_ifg_us_ = this->model_.ifg_us;
+  ESP_LOGI(TAG, "Model detected: %s after %u ms, %u heater cycles (%s)",
+           model_name(model), (unsigned)ms,
+           (unsigned)this->detector_.cycles_seen(), evidence);
+  if (this->detector_.by_default())
+    ESP_LOGW(TAG, "No model-specific registers seen, assuming %s; set "
+                  "model: in YAML if this is wrong",
+             model_name(model));
+  ESP_LOGI(TAG, "IFG selected: %d us, relay bitmasks: LIGHT=0x%08X "
+                "COILS=0x%08X (shift=%d)",
+           this->min_ifg_us_, (unsigned)this->model_.light_mask,
+           (unsigned)this->model_.coils_mask, (int)this->model_.coils_shift);
+  for (auto &listener : listeners_) {
+    listener->on_model_detected(model, ms);
+    listener->on_tx_delay(static_cast<uint32_t>(this->min_ifg_us_));
+  }
+}
+#endif
 
-    if (is_escaped) {
-      data = decode_escape_sequence(data);
-      is_escaped = false;
+void SAUNA360Component::update_power_state_(uint32_t now) {
+  const bool active = this->last_heater_on_ || this->session_active_ ||
+                      this->tx_pending_() || this->pending_profile_ != nullptr;
+  if (active != this->pm_.is_active()) {
+    this->pm_.set_active(active);
+    if (active)
+      this->high_freq_.start();
+    else
+      this->high_freq_.stop();
+  }
+  this->pm_.loop(now);
+}
+
+void SAUNA360Component::publish_diagnostics_() {
+  const uint32_t rx_free = this->bus_.rx_stack_free();
+  const uint32_t loop_free = BusPort::current_stack_free();
+#ifdef SAUNA360_RX_DMA
+  const uint32_t dropped = this->dropped_frames_ + this->bus_.dma_overruns();
+#else
+  const uint32_t dropped = this->dropped_frames_;
+#endif
+  for (auto &listener : listeners_) {
+    listener->on_rx_stack_free(rx_free);
+    listener->on_loop_stack_free(loop_free);
+    listener->on_dropped_frames(dropped);
+    listener->on_latency(this->latency_);
+    listener->on_arbitration(this->arbiter_);
+#ifdef SAUNA360_CYCLE_LEARNER
+    listener->on_cycle_learner(this->cycles_);
+#endif
+#ifdef SAUNA360_FRAME_STREAM
+    listener->on_stream_dropped(this->stream_.dropped());
+#endif
+  }
+
+  const uint32_t abandoned = this->arbiter_.abandoned();
+  if (abandoned != this->abandoned_logged_) {
+    ESP_LOGW(TAG, "%u frames dropped after %u collisions each",
+             (unsigned)(abandoned - this->abandoned_logged_),
+             (unsigned)this->arbiter_.max_retries() + 1);
+    this->abandoned_logged_ = abandoned;
+  }
+
+  if (this->power_save_) {
+    const uint32_t freq = this->pm_.take_avg_cpu_freq_mhz();
+    const uint32_t wakes = this->pm_.wake_count();
+    for (auto &listener : listeners_) {
+      listener->on_cpu_frequency(freq);
+      listener->on_wake_count(wakes);
     }
+  }
 
-    packet.push_back(data);
+#ifdef SAUNA360_HEAP_AUDIT
+  // The first interval covers start-up and the first publish of every entity
+  const uint32_t rx = heap_audit::rx_allocs();
+  const uint32_t lp = heap_audit::loop_allocs();
+  if (this->audit_warm_ &&
+      (rx != this->audit_rx_allocs_ || lp != this->audit_loop_allocs_)) {
+    ESP_LOGW(TAG, "Heap audit: %u RX / %u loop allocations in steady state",
+             (unsigned)(rx - this->audit_rx_allocs_),
+             (unsigned)(lp - this->audit_loop_allocs_));
+  } else if (this->audit_warm_) {
+    ESP_LOGD(TAG, "Heap audit: no allocations in the last interval");
   }
+  this->audit_rx_allocs_ = rx;
+  this->audit_loop_allocs_ = lp;
+  this->audit_warm_ = true;
+#endif
+}
 
-  if (!validate_packet(packet)) {
-    ESP_LOGI(TAG, "Invalid packet size or CRC error");
+void SAUNA360Component::handle_byte_(uint8_t c) {
+  if (c == 0x98) {
+    this->frame_flag_ = true;
+    this->rx_len_ = 0;
+  }
+  if (c == 0x9C) {
+    // EOF without SOF: frame start lost (e.g. while waking from sleep)
+    if (!this->frame_flag_ || this->rx_len_ >= RX_BUF_LEN) {
+      this->dropped_frames_ = this->dropped_frames_ + 1;
+      if (this->frame_flag_) {
+        this->arbiter_.on_frame(this->rx_buf_, RX_BUF_LEN, false,
+                                this->rx_byte_us_);
+        this->capture_(this->rx_buf_, RX_BUF_LEN, protocol::REC_TRUNC,
+                       this->rx_byte_us_);
+      }
+    } else {
+      this->rx_buf_[this->rx_len_++] = c;
+      this->handle_rx_frame_(this->rx_buf_, this->rx_len_);
+    }
+    this->rx_len_ = 0;
+    this->frame_flag_ = false;
     return;
   }
+  if (this->frame_flag_ == true) {
+    // Oversized frames are kept until EOF and then dropped
+    if (this->rx_len_ < RX_BUF_LEN)
+      this->rx_buf_[this->rx_len_] = c;
+    if (this->rx_len_ < 0xFF)
+      this->rx_len_++;
+  }
+}
 
-  this->handle_packet_(packet);
+// RX task: one SOF..EOF frame, from rx_buf_ or in place in a DMA buffer
+void SAUNA360Component::handle_rx_frame_(const uint8_t *frame, size_t len) {
+  if (this->injecting_()) {
+    if (len > 6)
+      this->handle_frame_(frame, len);
+    return;
+  }
+#ifdef SAUNA360_CYCLE_LEARNER
+  // Ends the window before it, before 0x6000 starts a new cycle
+  this->cycles_.on_frame_start(this->rx_byte_us_ -
+                               (len - 1) * TxArbiter::CHAR_TIME_US);
+#endif
+  bool valid = false;
+  if (len > 6)
+    valid = this->handle_frame_(frame, len);
+  this->arbiter_.on_frame(frame, len, valid, this->rx_byte_us_);
+  // Type byte 0x07 / 0x09: panel -> heater
+  uint8_t flags = valid ? protocol::REC_VALID : 0;
+  if (len > 2 && (frame[2] == 0x07 || frame[2] == 0x09))
+    flags |= protocol::REC_PANEL;
+  this->capture_(frame, len, flags, this->rx_byte_us_);
+#ifdef SAUNA360_FLIGHT_RECORDER
+  if (this->recorder_.snapshot_due(millis()))
+    this->recorder_snapshot_();
+#endif
 }
 
-uint8_t SAUNA360Component::decode_escape_sequence(uint8_t data) {
-  switch (data) {
-  case 0x63:
-    return 0x9C; // EOF
-  case 0x67:
-    return 0x98; // SOF
-  case 0x6E:
-    return 0x91; // ESC
-  default:
-    ESP_LOGI(TAG, "Unknown escape sequence: %02X", data);
-    return 0x91; // Return original escape character for unknown sequences
+// Returns true if the frame passed the CRC check
+bool SAUNA360Component::handle_frame_(const uint8_t *frame, size_t len) {
+  uint8_t packet[protocol::PAYLOAD_LEN + 2];
+  const size_t packet_len = protocol::unescape_frame(frame, len, packet);
+
+  if (!validate_packet(packet, packet_len)) {
+    ESP_LOGI(TAG, "Invalid packet size or CRC error");
+    this->dropped_frames_ = this->dropped_frames_ + 1;
+    return false;
   }
+  this->rx_valid_us_ = micros();
+  if (!this->injecting_())
+    this->latency_.record(LatencyMonitor::RX_FRAME, this->rx_byte_us_,
+                          this->rx_valid_us_);
+
+  this->handle_packet_(packet, packet_len - 2);
+  return true;
 }
 
-bool SAUNA360Component::validate_packet(std::vector<uint8_t> &packet) {
-  if (packet.size() < 2) {
+// `len` includes the trailing CRC
+bool SAUNA360Component::validate_packet(const uint8_t *packet, size_t len) {
+  if (len < 2) {
     return false;
   }
 
-  uint16_t crc = (packet.end()[-2] << 8) | packet.end()[-1];
-  packet.resize(packet.size() - 2);
+  uint16_t crc = (packet[len - 2] << 8) | packet[len - 1];
+  len -= 2;
 
-  uint16_t calculated_crc =
-      crc16be(packet.data(), packet.size(), 0xFFFF, 0x90D9, false, false);
+  uint16_t calculated_crc = protocol::crc16(packet, len);
   if (crc != calculated_crc) {
-    std::string packet_str;
-    for (size_t i = 0; i < packet.size(); ++i) {
-      char buffer[4];
-      snprintf(buffer, sizeof(buffer), " %02X", packet[i]);
-      packet_str += buffer;
-    }
+    char packet_str[(protocol::PAYLOAD_LEN + 2) * 3];
     ESP_LOGI(TAG, "CRC ERROR: Expected %04X, got %04X. Full packet:[%s]", crc,
-             calculated_crc, packet_str.c_str());
+             calculated_crc,
+             protocol::format_hex(packet, len, packet_str, sizeof(packet_str)));
+    this->ifg_.on_crc_error();
+#ifdef SAUNA360_FLIGHT_RECORDER
+    this->recorder_.on_crc_error(millis());
+#endif
     return false;
   }
   return true;
 }
 
-void SAUNA360Component::handle_packet_(std::vector<uint8_t> packet) {
-  if (packet.size() < 8) {
-    ESP_LOGW(TAG, "Packet too short: %u", (unsigned)packet.size());
+void SAUNA360Component::handle_packet_(const uint8_t *packet, size_t len) {
+  if (len < protocol::PAYLOAD_LEN) {
+    ESP_LOGW(TAG, "Packet too short: %u", (unsigned)len);
     return;
   }
   uint8_t packet_type = packet[1];
   uint16_t code = encode_uint16(packet[2], packet[3]);
   uint32_t data = encode_uint32(packet[4], packet[5], packet[6], packet[7]);
+  const uint32_t now = millis();
+  this->last_frame_ms_ = now;
+  const bool live = !this->injecting_();
 
   const bool from_panel = (packet_type == 0x07) || (packet_type == 0x09);
 
+  if (live)
+    this->registers_.update(from_panel ? RegisterMap::PANEL_TO_HEATER
+                                       : RegisterMap::HEATER_TO_PANEL,
+                            code, data, now);
+  if (live && this->discovery_ != nullptr && !from_panel)
+    this->discovery_->on_frame(code, data, now);
+#ifdef SAUNA360_CUSTOM_REGISTERS
+  this->custom_.dispatch(from_panel ? RegisterMap::PANEL_TO_HEATER
+                                    : RegisterMap::HEATER_TO_PANEL,
+                         code, data);
+#endif
+#ifdef SAUNA360_FLIGHT_RECORDER
+  if (live)
+    this->recorder_.on_frame(code, data);
+#endif
+
+  // Heater cadence for the watchdog (EWMA, 1/8)
+  if (live && !from_panel && code == 0x6000) {
+    const uint32_t interval = now - this->last_cycle_frame_ms_;
+    if (this->last_cycle_frame_ms_ != 0 && interval < 60000u) {
+      this->bus_cycle_ms_ = (this->bus_cycle_ms_ == 0)
+                                ? interval
+                                : (this->bus_cycle_ms_ * 7 + interval) / 8;
+    }
+    this->last_cycle_frame_ms_ = now;
+  }
+
+  char hex[protocol::PAYLOAD_LEN * 3];
+  protocol::format_hex(packet, len, hex, sizeof(hex));
   if (from_panel) {
-    ESP_LOGD(TAG, "%s [ HEATER <-- PANEL ] CODE %04X DATA 0x%08X",
-             format_hex_pretty(packet).c_str(), code, data);
-    packet.clear();
+    ESP_LOGD(TAG, "%s [ HEATER <-- PANEL ] CODE %04X DATA 0x%08X", hex, code,
+             data);
     return;
   }
 
-  ESP_LOGD(TAG, "%s [ HEATER --> PANEL ] CODE %04X DATA 0x%08X",
-           format_hex_pretty(packet).c_str(), code, data);
+  ESP_LOGD(TAG, "%s [ HEATER --> PANEL ] CODE %04X DATA 0x%08X", hex, code,
+           data);
+
+#ifdef SAUNA360_CYCLE_LEARNER
+  if (live)
+    this->cycles_.on_event(code, this->rx_byte_us_);
+#endif
+#ifdef SAUNA360_MODEL_AUTO
+  if (live && this->detector_.on_frame(code, data, now)) {
+    this->model_.select(this->detector_.model());
+    this->model_known_ = true;
+    this->model_changed_ = true;
+  }
+#endif
+
+  const uint32_t dispatch_us = micros();
+  if (live)
+    this->latency_.record(LatencyMonitor::RX_DISPATCH, this->rx_valid_us_,
+                          dispatch_us);
 
   switch (code) {
   case 0x3400:
@@ -275,16 +596,22 @@ void SAUNA360Component::handle_packet_(std::vector<uint8_t> packet) {
     this->process_temperature(data);
     break;
   case 0x6001:
-    this->process_humidity_control(data);
+    if (this->model_.humidity != HumidityMode::NONE)
+      this->process_humidity_control(data);
     break;
   case 0x7000:
     this->process_heater_error(data);
     break;
   case 0x7180:
+#ifdef SAUNA360_MODEL_AUTO
+    if (!this->model_known_)
+      break; // masks unknown yet
+#endif
     this->process_relay_bitmap(data);
     break;
   case 0x7280:
-    this->process_tank_level(data);
+    if (this->model_.water_tank)
+      this->process_tank_level(data);
     break;
   case 0x9000:
     this->process_time_limit(data);
@@ -305,6 +632,17 @@ void SAUNA360Component::handle_packet_(std::vector<uint8_t> packet) {
       ESP_LOGD(TAG, "Unhandled packet code: %04X", code);
     break;
   }
+
+  const uint32_t published_us = micros();
+  if (live) {
+    this->latency_.record(LatencyMonitor::RX_PUBLISH, dispatch_us,
+                          published_us);
+    this->latency_.record(LatencyMonitor::RX_TOTAL, this->rx_byte_us_,
+                          published_us);
+  }
+
+  if (live)
+    this->mark_profile_seen_(code);
 }
 
 void SAUNA360Component::process_heater_status(uint32_t data) {
@@ -318,28 +656,7 @@ void SAUNA360Component::process_heater_status(uint32_t data) {
 
 // Raw 12-bit -> minutes (bucketed)
 int SAUNA360Component::decode_bath_time_minutes_(uint16_t raw12) const {
-  int raw = static_cast<int>(raw12);
-  if (raw < 0)
-    raw = 0;
-  if (raw > 4095)
-    raw = 4095;
-
-  if (raw < 64)
-    return raw;
-
-  int k = (raw / 64) - 1; // 0..7 for raw >= 64
-  if (k < 0)
-    k = 0;
-  if (k > 7)
-    k = 7;
-  int offset = 4 * (k + 1); // 4,8,12,16,20,24,28,32
-
-  int minutes = raw - offset;
-  if (minutes < 0)
-    minutes = 0;
-  if (minutes > 575)
-    minutes = 575;
-  return minutes;
+  return protocol::bath_time_minutes(raw12);
 }
 
 // minutes -> Raw 12-bit (inverse of above)
@@ -377,7 +694,6 @@ void SAUNA360Component::process_bath_time(uint32_t data) {
 
   // Snap logic
   constexpr uint32_t SNAP_WINDOW_MS = 1000; // 1s
-  constexpr int SNAP_TOL_MIN = 8;           // ±8 min
 
   int to_publish = decoded;
 
@@ -386,7 +702,8 @@ void SAUNA360Component::process_bath_time(uint32_t data) {
   const bool within_window = have_intent && (dt <= SNAP_WINDOW_MS);
   const bool close_to_target =
       have_intent &&
-      (std::abs(decoded - this->last_bath_time_target_) <= SNAP_TOL_MIN);
+      (std::abs(decoded - this->last_bath_time_target_) <=
+       BATH_TIME_SNAP_TOL_MIN);
 
   const bool heater_on = this->heating_status_ || this->last_heater_on_;
 
@@ -457,7 +774,26 @@ void SAUNA360Component::process_temperature(uint32_t data) {
   }
 
   int setpoint_temp = ((data >> 11) & 0x00007FF) / 9.0;
-  this->setpoint_temperature_received_hex_ = ((data >> 11) & 0x00007FF);
+  const uint32_t setpoint_hex = (data >> 11) & 0x00007FF;
+  if (this->setpoint_temperature_received_hex_ != 0 &&
+      setpoint_hex != this->setpoint_temperature_received_hex_)
+    this->discovery_event_(BitDiscovery::EVENT_SETPOINT_CHANGE);
+  this->setpoint_temperature_received_hex_ = setpoint_hex;
+  if (this->anomaly_enabled_ && !this->injecting_()) {
+    const uint32_t now = millis();
+    this->anomaly_.on_setpoint(setpoint_hex, now);
+    this->anomaly_.on_temperature(this->temperature_received_hex_, now);
+  }
+#ifdef SAUNA360_JOURNAL
+  if (this->session_active_ && !this->injecting_()) {
+    const uint16_t t = this->temperature_received_hex_;
+    if (t > this->journal_peak_raw_)
+      this->journal_peak_raw_ = t;
+    this->journal_temp_sum_ += t;
+    this->journal_temp_n_++;
+    this->journal_rec_.setpoint_end = static_cast<uint8_t>(setpoint_temp);
+  }
+#endif
 
   if (this->bath_temperature_number_ != nullptr) {
     if (this->bath_temperature_number_->state != setpoint_temp) {
@@ -543,13 +879,22 @@ void SAUNA360Component::process_humidity_control(uint32_t data) {
   ESP_LOGI(TAG, "Priority: %s", priority);
 }
 
+// States are string literals: unchanged states are skipped by pointer
+void SAUNA360Component::publish_heater_state_(const char *state) {
+  if (state == this->heater_state_)
+    return;
+  this->heater_state_ = state;
+  for (auto &listener : listeners_)
+    listener->on_heater_state(state);
+#ifdef SAUNA360_FLIGHT_RECORDER
+  if (!this->injecting_())
+    this->recorder_.on_heater_state();
+#endif
+}
+
 void SAUNA360Component::process_heater_error(uint32_t data) {
-  if (!this->state_changed_ && !this->heating_status_) {
-    std::string value = "Operation blocked by not allowed start";
-    for (auto &listener : listeners_) {
-      listener->on_heater_state(value);
-    }
-  }
+  if (!this->state_changed_ && !this->heating_status_)
+    this->publish_heater_state_(STATE_BLOCKED);
   this->state_changed_ = false;
 }
 
@@ -558,15 +903,18 @@ void SAUNA360Component::process_relay_bitmap(uint32_t data) {
   const bool prev_heater_on = this->last_heater_on_;
 
   // Decode light using model-specific mask
-  const bool light_on = (data & this->LIGHT_MASK_) != 0;
+  const bool light_on = (data & this->model_.light_mask) != 0;
 
   // Decode coils using model-specific mask/shift
   const uint8_t coilmap =
-      static_cast<uint8_t>((data & this->COILS_MASK_) >> this->COILS_SHIFT_);
+      static_cast<uint8_t>((data & this->model_.coils_mask) >>
+                           this->model_.coils_shift);
   const bool c1 = (coilmap & 0x01) != 0;
   const bool c2 = (coilmap & 0x02) != 0;
   const bool c3 = (coilmap & 0x04) != 0;
   const int active_coils = (c1 ? 1 : 0) + (c2 ? 1 : 0) + (c3 ? 1 : 0);
+  if (this->anomaly_enabled_ && !this->injecting_())
+    this->anomaly_.on_coils(static_cast<uint8_t>(active_coils), millis());
   const bool any_coil = (active_coils > 0);
 
   for (auto &l : listeners_)
@@ -575,15 +923,6 @@ void SAUNA360Component::process_relay_bitmap(uint32_t data) {
   // Consider heater enabled if status flag or any coil energized
   const bool heater_enabled = this->heating_status_ || any_coil;
 
-  // Optional AUX (we only log if present for COMBI/ELITE)
-  const uint32_t AUX1_MASK = 0x00040000;
-  const uint32_t AUX2_MASK = 0x00080000;
-  const uint32_t AUX3_MASK = 0x00100000;
-  const uint32_t AUX_MASK = (AUX1_MASK | AUX2_MASK | AUX3_MASK);
-  const bool aux1_on = (data & AUX1_MASK) != 0;
-  const bool aux2_on = (data & AUX2_MASK) != 0;
-  const bool aux3_on = (data & AUX3_MASK) != 0;
-
   // Raw frame log
   ESP_LOGI(TAG, "0x7180 raw: 0x%08X (bits:%02X.%02X.%02X.%02X)", data,
            (data >> 24) & 0xFF, (data >> 16) & 0xFF, (data >> 8) & 0xFF,
@@ -607,15 +946,26 @@ void SAUNA360Component::process_relay_bitmap(uint32_t data) {
       TAG, "Light: %s, Heater: %s, Coils: %s (active: %d, map: 0b%s [C3C2C1])",
       ONOFF(light_on), derived_state, coil_tuple, active_coils, coilmap_bin);
 
-  if (this->mode_ == Mode::COMBI || this->mode_ == Mode::ELITE) {
-    if ((data & AUX_MASK) != 0) {
-      ESP_LOGI(TAG, "AUX relays: [%s,%s,%s]", ONOFF(aux1_on), ONOFF(aux2_on),
-               ONOFF(aux3_on));
+  // Optional AUX (only logged for COMBI/ELITE)
+  if (this->model_.aux_relays) {
+    static constexpr uint32_t AUX1_MASK = 0x00040000;
+    static constexpr uint32_t AUX2_MASK = 0x00080000;
+    static constexpr uint32_t AUX3_MASK = 0x00100000;
+    if ((data & (AUX1_MASK | AUX2_MASK | AUX3_MASK)) != 0) {
+      ESP_LOGI(TAG, "AUX relays: [%s,%s,%s]", ONOFF(data & AUX1_MASK),
+               ONOFF(data & AUX2_MASK), ONOFF(data & AUX3_MASK));
     } else {
       ESP_LOGI(TAG, "AUX relays: [-]");
     }
   }
 
+  if (!prev_heater_on && heater_enabled)
+    this->discovery_event_(BitDiscovery::EVENT_HEATER_ON);
+  else if (prev_heater_on && !heater_enabled)
+    this->discovery_event_(BitDiscovery::EVENT_HEATER_OFF);
+  if (this->relays_known_ && light_on != this->last_light_on_)
+    this->discovery_event_(BitDiscovery::EVENT_LIGHT_TOGGLE);
+
   // Session timer: track OFF -> ON and ON -> OFF
   if (!prev_heater_on && heater_enabled) {
     this->session_active_ = true;
@@ -623,14 +973,23 @@ void SAUNA360Component::process_relay_bitmap(uint32_t data) {
     this->session_frozen_s_ = 0;
     this->last_session_pub_ms_ = millis();
     this->publish_session_();
+#ifdef SAUNA360_JOURNAL
+    this->journal_begin_();
+#endif
   } else if (prev_heater_on && !heater_enabled) {
     if (this->session_active_) {
       const uint32_t now = millis();
       this->session_frozen_s_ = (now - this->session_start_ms_) / 1000u;
       this->session_active_ = false;
       this->publish_session_();
+#ifdef SAUNA360_JOURNAL
+      this->journal_end_();
+#endif
     }
   }
+#ifdef SAUNA360_JOURNAL
+  this->journal_coils_(any_coil);
+#endif
 
   // Publish to HA switches
   if (this->light_relay_switch_ != nullptr)
@@ -663,12 +1022,11 @@ void SAUNA360Component::process_relay_bitmap(uint32_t data) {
   }
 
   // Notify listeners
-  std::string state_str(derived_state);
   for (auto &listener : listeners_) {
     listener->on_light_status(light_on);
     listener->on_heater_status(heater_enabled);
-    listener->on_heater_state(state_str);
   }
+  this->publish_heater_state_(derived_state);
 }
 
 void SAUNA360Component::process_tank_level(uint32_t data) {
@@ -729,6 +1087,10 @@ void SAUNA360Component::process_remaining_time(uint32_t data) {
   for (auto &listener : listeners_) {
     listener->on_remaining_time(minutes);
   }
+#ifdef SAUNA360_JOURNAL
+  if (this->session_active_ && raw == 0)
+    this->journal_end_hint_ = SessionJournal::END_TIME_UP;
+#endif
 
   // Log as unsigned to avoid negative prints
   ESP_LOGI(TAG, "Remaining time: %u minutes (raw=0x%04X%s)",
@@ -740,49 +1102,47 @@ void SAUNA360Component::process_door_error(uint32_t data) {
   for (auto &listener : listeners_) {
     listener->on_ready_status((~data) & 1);
   }
+  if (data & 1)
+    this->discovery_event_(BitDiscovery::EVENT_DOOR_ERROR);
+#ifdef SAUNA360_JOURNAL
+  if ((data & 1) && this->session_active_ &&
+      this->journal_rec_.door_events < 0xFF)
+    this->journal_rec_.door_events++;
+  if (data == 0x00130003)
+    this->journal_end_hint_ = SessionJournal::END_DOOR;
+#endif
   if (data == 0x00060001) {
-    std::string value = "Operation blocked by not allowed start";
-    for (auto &listener : listeners_) {
-      listener->on_heater_state(value);
-    }
+    this->publish_heater_state_(STATE_BLOCKED);
     this->create_send_data_(0x07, 0xB000, 0x00060101);
   }
   if (data == 0x00130001) {
-    std::string value = "Operation blocked by not allowed start";
-    for (auto &listener : listeners_) {
-      listener->on_heater_state(value);
-    }
+    this->publish_heater_state_(STATE_BLOCKED);
     this->create_send_data_(0x07, 0xB000, 0x00130101);
   }
   if (data == 0x00130003) {
-    std::string value = "Door opened too long, bath cancelled";
-    for (auto &listener : listeners_) {
-      listener->on_heater_state(value);
-    }
+    this->publish_heater_state_("Door opened too long, bath cancelled");
     this->create_send_data_(0x07, 0xB000, 0x00130103);
   }
   if (data == 0x00140003) {
-    std::string value = "Door has been open, check sauna";
-    for (auto &listener : listeners_) {
-      listener->on_heater_state(value);
-    }
+    this->publish_heater_state_("Door has been open, check sauna");
     this->create_send_data_(0x07, 0xB000, 0x00140000);
   }
 }
 
 void SAUNA360Component::process_sensor_error(uint32_t data) {
-  std::string error_message;
+  const char *error_message = nullptr;
   if ((data & 0xF0000000) == 0x30000000) {
     error_message = "Room temperature sensor not connected or malfunctioning";
   } else if ((data & 0xF0000000) == 0x10000000) {
     error_message = "High temperature limit control tripped, must be reset";
   }
 
-  if (!error_message.empty()) {
-    for (auto &listener : listeners_) {
-      listener->on_heater_state(error_message);
-    }
-    ESP_LOGI(TAG, "Sensor error: %s", error_message.c_str());
+  if (error_message != nullptr) {
+    this->publish_heater_state_(error_message);
+    ESP_LOGI(TAG, "Sensor error: %s", error_message);
+#ifdef SAUNA360_JOURNAL
+    this->journal_end_hint_ = SessionJournal::END_ERROR;
+#endif
   }
 }
 
@@ -806,7 +1166,13 @@ void SAUNA360Component::set_max_bath_temperature_number(float value) {
 }
 
 void SAUNA360Component::set_bath_time_number(float value) {
-  int target = static_cast<int>(std::lround(value));
+  this->queue_bath_time_(static_cast<int>(std::lround(value)), NAN);
+}
+
+// 0x4002 carries bath time (low 12 bits) and max bath temperature (high 12
+// bits). A NAN max temperature keeps the heater's value (or the default).
+void SAUNA360Component::queue_bath_time_(int target,
+                                         float max_bath_temperature) {
   if (target < 0)
     target = 0;
   if (target > 575)
@@ -818,8 +1184,12 @@ void SAUNA360Component::set_bath_time_number(float value) {
   const int encoded = this->encode_bath_time_raw_(target);
   uint32_t payload = static_cast<uint32_t>(encoded) & 0x0FFF;
 
-  // High bits: max bath temperature (12 Bit) keep/set
-  if (this->max_bath_temperature_received_hex_) {
+  // High bits: max bath temperature (12 Bit) set/keep
+  if (!std::isnan(max_bath_temperature)) {
+    const uint32_t hi =
+        (static_cast<uint32_t>(std::round(max_bath_temperature)) * 18) & 0xFFF;
+    payload |= (hi << 20);
+  } else if (this->max_bath_temperature_received_hex_) {
     payload |= ((this->max_bath_temperature_received_hex_ & 0xFFF) << 20);
   } else {
     const uint32_t hi =
@@ -845,6 +1215,8 @@ void SAUNA360Component::set_bath_temperature_number(float value) {
   data |= (this->temperature_received_hex_ & 0x000007FF); // keep current temp
 
   this->create_send_data_(0x07, 0x6000, data);
+  if (this->anomaly_enabled_)
+    this->anomaly_.on_setpoint_command(static_cast<int>(value), millis());
   ESP_LOGI(TAG, "SENT: Bath temperature: %.0f°C", value);
 }
 
@@ -890,7 +1262,12 @@ void SAUNA360Component::set_heater_relay(bool enable) {
   ESP_LOGI(TAG, "HEATER toggle sent (target=%s)", enable ? "ON" : "OFF");
 }
 
-void SAUNA360Component::set_humidity_step_number(float value) {
+bool SAUNA360Component::set_humidity_step_number(float value) {
+  if (this->model_.humidity != HumidityMode::STEP) {
+    ESP_LOGW(TAG, "Humidity step not supported by %s",
+             model_name(this->model_.model));
+    return false;
+  }
   int v = static_cast<int>(std::lround(value));
   if (v < 0)
     v = 0;
@@ -914,9 +1291,15 @@ void SAUNA360Component::set_humidity_step_number(float value) {
     this->humidity_step_published_ = true;
   }
 #endif
+  return true;
 }
 
-void SAUNA360Component::set_humidity_percent_number(float value) {
+bool SAUNA360Component::set_humidity_percent_number(float value) {
+  if (this->model_.humidity != HumidityMode::PERCENT) {
+    ESP_LOGW(TAG, "Humidity percent not supported by %s",
+             model_name(this->model_.model));
+    return false;
+  }
   int v = static_cast<int>(std::lround(value));
   if (v < 0)
     v = 0;
@@ -938,38 +1321,138 @@ void SAUNA360Component::set_humidity_percent_number(float value) {
     this->humidity_percent_published_ = true;
   }
 #endif
+  return true;
 }
 
 void SAUNA360Component::create_send_data_(uint8_t type, uint16_t code,
                                           uint32_t data) {
-  ESP_LOGD(TAG, "CREATING SEND DATA TYPE:%s CODE:%s DATA:%s",
-           format_hex_pretty(type).c_str(), format_hex_pretty(code).c_str(),
-           format_hex_pretty(data).c_str());
+  const uint32_t created_us = micros();
+  ESP_LOGD(TAG, "CREATING SEND DATA TYPE:%02X CODE:%04X DATA:%08X", type,
+           code, (unsigned)data);
 
-  std::vector<uint8_t> packet = {0x40, type};
-  std::array<uint8_t, 2> code_array = decode_value(code);
-  std::array<uint8_t, 4> data_array = decode_value(data);
+  if (this->bus_state_ == BusState::DOWN) {
+    ESP_LOGW(TAG, "Bus unavailable, command %04X dropped", code);
+    return;
+  }
+
+  TxFrame frame;
+  frame.len = static_cast<uint8_t>(
+      protocol::encode_frame(type, code, data, frame.data));
+  frame.created_us = created_us;
+
+  // Door acks from the RX task never join a batch of the main loop
+  if (this->tx_batch_open_ && !this->bus_.in_rx_task()) {
+    if (this->tx_batch_len_ < TX_BATCH_MAX) {
+      this->tx_batch_[this->tx_batch_len_++] = frame;
+    } else {
+      ESP_LOGW(TAG, "TX batch full, frame %04X dropped", code);
+    }
+    return;
+  }
+  this->push_tx_frames_(&frame, 1);
+}
+
+bool SAUNA360Component::push_tx_frames_(TxFrame *frames, uint8_t count) {
+  LockGuard guard(this->tx_lock_);
+  const uint8_t head = this->tx_head_.load(std::memory_order_acquire);
+  uint8_t tail = this->tx_tail_.load(std::memory_order_relaxed);
+  const uint8_t used = static_cast<uint8_t>(tail - head);
+  if (TX_QUEUE_LEN - used < count) {
+    ESP_LOGW(TAG, "TX queue full, %u frame(s) dropped", (unsigned)count);
+    return false;
+  }
+  const uint32_t now_us = micros();
+  for (uint8_t i = 0; i < count; i++) {
+    TxFrame &slot = this->tx_queue_[tail & (TX_QUEUE_LEN - 1)];
+    slot = frames[i];
+    slot.more = (i + 1) < count;
+    slot.queued_us = now_us;
+    tail++;
+  }
+  this->tx_tail_.store(tail, std::memory_order_release);
+  return true;
+}
 
-  packet.insert(packet.end(), code_array.begin(), code_array.end());
-  packet.insert(packet.end(), data_array.begin(), data_array.end());
+// Main loop. Only the RX task moves tx_head_, so the flush is handed to it
+// (handle_slot_) rather than done here.
+void SAUNA360Component::flush_tx_queue_() {
+  this->tx_flush_.store(true, std::memory_order_release);
+}
 
-  uint16_t crc_calculated =
-      crc16be(packet.data(), packet.size(), 0xffff, 0x90d9, false, false);
-  std::array<uint8_t, 2> crc_array = decode_value(crc_calculated);
-  packet.insert(packet.end(), crc_array.begin(), crc_array.end());
+void SAUNA360Component::begin_tx_batch_() {
+  this->tx_batch_len_ = 0;
+  this->tx_batch_open_ = true;
+}
 
-  packet.insert(packet.begin(), 0x98); // SOF
-  packet.push_back(0x9C);              // EOF
+void SAUNA360Component::commit_tx_batch_() {
+  this->tx_batch_open_ = false;
+  if (this->tx_batch_len_ == 0)
+    return;
+  if (this->push_tx_frames_(this->tx_batch_, this->tx_batch_len_)) {
+    ESP_LOGD(TAG, "TX batch queued: %u frames in one bus window",
+             (unsigned)this->tx_batch_len_);
+  }
+  this->tx_batch_len_ = 0;
+}
 
-  this->tx_queue_.push(packet);
+// RX task: writes the frame at the head of the queue, plus the rest of its
+// batch, back-to-back. `slot_us` is the receipt time of the granting EOF.
+void SAUNA360Component::send_data_(uint32_t slot_us) {
+  uint8_t head = this->tx_head_.load(std::memory_order_relaxed);
+  const uint8_t tail = this->tx_tail_.load(std::memory_order_acquire);
+  while (head != tail) {
+    TxFrame &frame = this->tx_queue_[head & (TX_QUEUE_LEN - 1)];
+    this->bus_.write(frame.data, frame.len);
+    const uint32_t written_us = micros();
+    this->ifg_.on_own_tx();
+#ifdef SAUNA360_CYCLE_LEARNER
+    this->cycles_.on_tx();
+#endif
+#ifdef SAUNA360_RS485
+    if (this->bus_.tx_collided()) {
+      // The frame stays at the head and, with the rest of its batch, goes
+      // out again in a later slot once the backoff has run down
+      if (!this->arbiter_.on_collision(++frame.tries))
+        head++; // out of retries
+      break;
+    }
+#endif
+    this->latency_.record(LatencyMonitor::TX_ENQUEUE, frame.created_us,
+                          frame.queued_us);
+    this->latency_.record(LatencyMonitor::TX_WAIT, frame.queued_us, slot_us);
+#ifdef SAUNA360_CYCLE_LEARNER
+    this->cycles_.on_sent(written_us - frame.queued_us);
+#endif
+    this->latency_.record(LatencyMonitor::TX_WRITE, slot_us, written_us);
+    this->latency_.record(LatencyMonitor::TX_TOTAL, frame.created_us,
+                          written_us);
+    this->arbiter_.on_sent(frame.data, frame.len, written_us);
+    this->capture_(frame.data, frame.len,
+                   protocol::REC_VALID | protocol::REC_PANEL | protocol::REC_TX,
+                   written_us);
+    head++;
+    if (!frame.more)
+      break;
+  }
+  this->tx_head_.store(head, std::memory_order_release);
 }
 
-void SAUNA360Component::send_data_() {
-  const std::vector<uint8_t> &packet = this->tx_queue_.front();
-  static constexpr uart_port_t PORT = UART_NUM_0;
-  uart_write_bytes(PORT, (const char *)packet.data(), packet.size());
-  this->tx_queue_.pop();
+#ifdef SAUNA360_CYCLE_LEARNER
+uint32_t SAUNA360Component::head_batch_airtime_us_() const {
+  uint8_t head = this->tx_head_.load(std::memory_order_relaxed);
+  const uint8_t tail = this->tx_tail_.load(std::memory_order_acquire);
+  uint32_t bytes = 0;
+  while (head != tail) {
+    const TxFrame &frame = this->tx_queue_[head & (TX_QUEUE_LEN - 1)];
+    bytes += frame.len;
+    head++;
+    if (!frame.more)
+      break;
+  }
+  return this->min_ifg_us_ + this->arbiter_.slot_offset_us() +
+         bytes * TxArbiter::CHAR_TIME_US;
 }
+#endif
 
 void SAUNA360Component::publish_session_() {
   const uint32_t s = this->session_active_
@@ -989,6 +1472,219 @@ void SAUNA360Component::publish_session_() {
   }
 }
 
+#ifdef SAUNA360_JOURNAL
+// RX task, heater OFF -> ON
+void SAUNA360Component::journal_begin_() {
+  SessionJournal::Record &r = this->journal_rec_;
+  memset(&r, 0, sizeof(r));
+  // Before SNTP the clock counts from 1970; store 0 rather than nonsense
+  const time_t t = ::time(nullptr);
+  r.start_time = t > 1600000000 ? static_cast<uint32_t>(t) : 0;
+  r.setpoint_start =
+      static_cast<uint8_t>(this->setpoint_temperature_received_hex_ / 9);
+  r.setpoint_end = r.setpoint_start;
+  this->journal_peak_raw_ = this->temperature_received_hex_;
+  this->journal_temp_sum_ = 0;
+  this->journal_temp_n_ = 0;
+  this->journal_coil_ms_ = 0;
+  this->journal_coils_since_ms_ = millis();
+  this->journal_end_hint_ = SessionJournal::END_UNKNOWN;
+}
+
+// RX task, per relay frame: integrate coil-on time
+void SAUNA360Component::journal_coils_(bool on) {
+  const uint32_t now = millis();
+  if (this->journal_coils_on_ && this->session_active_)
+    this->journal_coil_ms_ += now - this->journal_coils_since_ms_;
+  this->journal_coils_on_ = on;
+  this->journal_coils_since_ms_ = now;
+}
+
+// RX task, heater ON -> OFF
+void SAUNA360Component::journal_end_() {
+  SessionJournal::Record &r = this->journal_rec_;
+  if (this->journal_coils_on_)
+    this->journal_coil_ms_ += millis() - this->journal_coils_since_ms_;
+  this->journal_coils_since_ms_ = millis();
+  r.duration_s = this->session_frozen_s_;
+  r.coil_on_s = this->journal_coil_ms_ / 1000u;
+  r.peak_temp_x10 = static_cast<int16_t>(this->journal_peak_raw_ * 10u / 9u);
+  r.avg_temp_x10 =
+      this->journal_temp_n_ == 0
+          ? r.peak_temp_x10
+          : static_cast<int16_t>(this->journal_temp_sum_ * 10u /
+                                 (9u * this->journal_temp_n_));
+  r.end_reason = this->journal_end_hint_ != SessionJournal::END_UNKNOWN
+                     ? this->journal_end_hint_
+                     : SessionJournal::END_HEATER_OFF;
+  this->journal_done_ = r;
+  this->journal_done_pending_ = true;
+}
+
+void SAUNA360Component::journal_loop_() {
+  if (this->journal_done_pending_) {
+    SessionJournal::Record r = this->journal_done_;
+    this->journal_done_pending_ = false;
+    if (this->journal_.append(r)) {
+      ESP_LOGI(TAG, "Session #%u journaled: %u s, peak %.1f C, end %s",
+               (unsigned)r.seq, (unsigned)r.duration_s, r.peak_temp_x10 / 10.0f,
+               SessionJournal::end_reason_name(r.end_reason));
+    } else {
+      ESP_LOGW(TAG, "Session journal write failed");
+    }
+  }
+
+  // Dump a few slots per pass so the log and the watchdog keep up
+  if (!this->journal_dumping_)
+    return;
+  SessionJournal::Record r;
+  for (uint32_t n = 0; n < JOURNAL_DUMP_PER_LOOP; n++) {
+    if (this->journal_dump_pos_ >= this->journal_.slots()) {
+      this->journal_dumping_ = false;
+      ESP_LOGI(TAG, "journal: end, %u sessions",
+               (unsigned)this->journal_.count());
+      return;
+    }
+    if (!this->journal_.read(this->journal_dump_pos_++, &r))
+      continue;
+    ESP_LOGI(TAG, "journal: %u,%u,%u,%u,%.1f,%.1f,%u,%u,%u,%s",
+             (unsigned)r.seq, (unsigned)r.start_time, (unsigned)r.duration_s,
+             (unsigned)r.coil_on_s, r.peak_temp_x10 / 10.0f,
+             r.avg_temp_x10 / 10.0f, (unsigned)r.setpoint_start,
+             (unsigned)r.setpoint_end, (unsigned)r.door_events,
+             SessionJournal::end_reason_name(r.end_reason));
+  }
+}
+#endif
+
+void SAUNA360Component::journal_dump() {
+#ifdef SAUNA360_JOURNAL
+  if (!this->journal_.ready()) {
+    ESP_LOGW(TAG, "Session journal unavailable");
+    return;
+  }
+  ESP_LOGI(TAG, "journal: seq,start_time,duration_s,coil_on_s,peak_c,avg_c,"
+                "setpoint_start,setpoint_end,door_events,end_reason");
+  this->journal_dump_pos_ = 0;
+  this->journal_dumping_ = true;
+#else
+  ESP_LOGW(TAG, "Session journal not configured");
+#endif
+}
+
+void SAUNA360Component::journal_clear() {
+#ifdef SAUNA360_JOURNAL
+  this->journal_dumping_ = false;
+  if (this->journal_.clear()) {
+    ESP_LOGI(TAG, "Session journal cleared");
+  } else {
+    ESP_LOGW(TAG, "Session journal clear failed");
+  }
+#else
+  ESP_LOGW(TAG, "Session journal not configured");
+#endif
+}
+
+#ifdef SAUNA360_FLIGHT_RECORDER
+// RX task, about once a second: decoded state between the raw frames
+void SAUNA360Component::recorder_snapshot_() {
+  FlightRecorder::Snapshot snap{};
+  snap.temperature_raw =
+      static_cast<uint16_t>(this->temperature_received_hex_);
+  snap.setpoint_raw =
+      static_cast<uint16_t>(this->setpoint_temperature_received_hex_);
+  snap.bath_time_raw = static_cast<uint16_t>(this->bath_time_received_hex_);
+  if (this->last_heater_on_)
+    snap.flags |= FlightRecorder::SNAP_HEATER_ON;
+  if (this->last_light_on_)
+    snap.flags |= FlightRecorder::SNAP_LIGHT_ON;
+  if (this->session_active_)
+    snap.flags |= FlightRecorder::SNAP_SESSION;
+  if (this->heating_status_)
+    snap.flags |= FlightRecorder::SNAP_HEATING;
+  if (this->bus_state_ == BusState::UP)
+    snap.flags |= FlightRecorder::SNAP_BUS_UP;
+  if (this->heater_state_ != nullptr)
+    strncpy(snap.state, this->heater_state_, sizeof(snap.state));
+  this->recorder_.record(reinterpret_cast<const uint8_t *>(&snap),
+                         sizeof(snap), protocol::REC_SNAPSHOT, micros());
+}
+
+void SAUNA360Component::recorder_loop_() {
+  this->recorder_.loop();
+
+  // Like the journal dump, a few records per pass
+  if (!this->recorder_dumping_)
+    return;
+  char hex[2 * sizeof(FlightRecorder::Record) + 1];
+  for (uint32_t n = 0; n < RECORDER_DUMP_PER_LOOP; n++) {
+    if (this->recorder_dump_pos_ < this->recorder_dump_count_) {
+      FlightRecorder::Record r;
+      if (!this->recorder_.read_record(this->recorder_dump_slot_,
+                                       this->recorder_dump_pos_++, &r))
+        continue;
+      const uint8_t *p = reinterpret_cast<const uint8_t *>(&r);
+      const size_t len = protocol::REC_HEADER_LEN +
+                         std::min<size_t>(r.len, sizeof(r.data));
+      for (size_t i = 0; i < len; i++)
+        snprintf(hex + 2 * i, 3, "%02X", p[i]);
+      ESP_LOGI(TAG, "recorder: rec %s", hex);
+      continue;
+    }
+    if (this->recorder_dump_count_ != 0) {
+      this->recorder_dump_slot_++;
+      this->recorder_dump_count_ = 0;
+    }
+    if (this->recorder_dump_slot_ >= this->recorder_.slots()) {
+      this->recorder_dumping_ = false;
+      ESP_LOGI(TAG, "recorder: end, %u captures",
+               (unsigned)this->recorder_.count());
+      return;
+    }
+    FlightRecorder::Header h;
+    if (!this->recorder_.read_header(this->recorder_dump_slot_, &h)) {
+      this->recorder_dump_slot_++;
+      continue;
+    }
+    ESP_LOGI(TAG, "recorder: cap %u,%u,%s,%04X,%08X,%u,%u,%u",
+             (unsigned)h.seq, (unsigned)h.unix_time,
+             FlightRecorder::reason_name(h.reason), (unsigned)h.code,
+             (unsigned)h.data, (unsigned)h.trigger_us, (unsigned)h.count,
+             (unsigned)h.trigger_index);
+    this->recorder_dump_pos_ = 0;
+    this->recorder_dump_count_ = h.count;
+    if (h.count == 0)
+      this->recorder_dump_slot_++;
+  }
+}
+#endif
+
+void SAUNA360Component::recorder_dump() {
+#ifdef SAUNA360_FLIGHT_RECORDER
+  if (!this->recorder_.ready()) {
+    ESP_LOGW(TAG, "Flight recorder unavailable");
+    return;
+  }
+  ESP_LOGI(TAG, "recorder: cap seq,unix_time,reason,code,data,trigger_us,"
+                "records,trigger_index");
+  this->recorder_dump_slot_ = 0;
+  this->recorder_dump_pos_ = 0;
+  this->recorder_dump_count_ = 0;
+  this->recorder_dumping_ = true;
+#else
+  ESP_LOGW(TAG, "Flight recorder not configured");
+#endif
+}
+
+void SAUNA360Component::recorder_trigger() {
+#ifdef SAUNA360_FLIGHT_RECORDER
+  if (!this->recorder_.trigger(FlightRecorder::REASON_MANUAL))
+    ESP_LOGW(TAG, "Flight recorder busy or still filling, not triggered");
+#else
+  ESP_LOGW(TAG, "Flight recorder not configured");
+#endif
+}
+
 void SAUNA360Component::initialize_defaults() {
   ESP_LOGI(TAG, "=========== Queueing default values ===========");
   if (!std::isnan(this->max_bath_temperature_default_))
@@ -1006,10 +1702,14 @@ void SAUNA360Component::initialize_defaults() {
 #endif
   ESP_LOGI(TAG, "================================================");
 
-  if (!std::isnan(this->bath_time_default_))
-    this->set_bath_time_number(this->bath_time_default_);
+  // All defaults go out back-to-back in the first panel window
+  this->begin_tx_batch_();
 
-  if (!std::isnan(this->max_bath_temperature_default_))
+  if (!std::isnan(this->bath_time_default_))
+    this->queue_bath_time_(
+        static_cast<int>(std::lround(this->bath_time_default_)),
+        this->max_bath_temperature_default_);
+  else if (!std::isnan(this->max_bath_temperature_default_))
     this->set_max_bath_temperature_number(this->max_bath_temperature_default_);
 
   if (!std::isnan(this->bath_temperature_default_))
@@ -1024,11 +1724,462 @@ void SAUNA360Component::initialize_defaults() {
       !std::isnan(this->humidity_percent_default_))
     this->set_humidity_percent_number(this->humidity_percent_default_);
 #endif
+
+  this->commit_tx_batch_();
+}
+
+void SAUNA360Component::add_profile(const std::string &name,
+                                    float bath_temperature, float bath_time,
+                                    float max_bath_temperature,
+                                    float humidity_step, float humidity_percent,
+                                    int heater) {
+  SAUNA360Profile p;
+  p.name = name;
+  p.bath_temperature = bath_temperature;
+  p.bath_time = bath_time;
+  p.max_bath_temperature = max_bath_temperature;
+  p.humidity_step = humidity_step;
+  p.humidity_percent = humidity_percent;
+  p.heater = static_cast<int8_t>(heater);
+  this->profiles_.push_back(p);
+}
+
+bool SAUNA360Component::apply_profile(const std::string &name) {
+  const SAUNA360Profile *p = nullptr;
+  for (const auto &candidate : this->profiles_) {
+    if (candidate.name == name) {
+      p = &candidate;
+      break;
+    }
+  }
+  if (p == nullptr) {
+    ESP_LOGW(TAG, "Unknown bath profile '%s'", name.c_str());
+    return false;
+  }
+
+  ESP_LOGI(TAG, "Applying bath profile '%s'", p->name.c_str());
+
+  uint8_t fields = 0;
+  this->begin_tx_batch_();
+
+  if (!std::isnan(p->bath_time)) {
+    // One 0x4002 frame covers bath time and max temperature
+    this->queue_bath_time_(static_cast<int>(std::lround(p->bath_time)),
+                           p->max_bath_temperature);
+    fields |= PROFILE_BATH_TIME;
+    if (!std::isnan(p->max_bath_temperature))
+      fields |= PROFILE_MAX_TEMPERATURE;
+  } else if (!std::isnan(p->max_bath_temperature)) {
+    this->set_max_bath_temperature_number(p->max_bath_temperature);
+    fields |= PROFILE_MAX_TEMPERATURE;
+  }
+
+  if (!std::isnan(p->bath_temperature)) {
+    this->set_bath_temperature_number(p->bath_temperature);
+    fields |= PROFILE_TEMPERATURE;
+  }
+
+  // Skipped when the model (or, under model: auto, no model yet) has no
+  // such control; not waited for then
+  if (!std::isnan(p->humidity_step)) {
+    if (this->set_humidity_step_number(p->humidity_step))
+      fields |= PROFILE_HUMIDITY;
+  } else if (!std::isnan(p->humidity_percent)) {
+    if (this->set_humidity_percent_number(p->humidity_percent))
+      fields |= PROFILE_HUMIDITY;
+  }
+
+  // Heater toggle last, so the settings are in place when the bath starts
+  if (p->heater >= 0) {
+    this->set_heater_relay(p->heater == 1);
+    fields |= PROFILE_HEATER;
+  }
+
+  this->commit_tx_batch_();
+
+  this->profile_seen_.store(0, std::memory_order_relaxed);
+  this->profile_fields_ = fields;
+  this->profile_applied_ms_ = millis();
+  this->pending_profile_ = (fields != 0) ? p : nullptr;
+  return true;
 }
 
+bool SAUNA360Component::profile_field_matches_(uint8_t field) const {
+  const SAUNA360Profile *p = this->pending_profile_;
+  switch (field) {
+  case PROFILE_TEMPERATURE:
+    return static_cast<int>(this->setpoint_temperature_received_hex_ / 9.0f) ==
+           static_cast<int>(std::round(p->bath_temperature));
+  case PROFILE_BATH_TIME: {
+    const int minutes =
+        this->decode_bath_time_minutes_(this->bath_time_received_hex_ & 0x0FFF);
+    return std::abs(minutes - static_cast<int>(std::lround(p->bath_time))) <=
+           BATH_TIME_SNAP_TOL_MIN;
+  }
+  case PROFILE_MAX_TEMPERATURE:
+    return static_cast<int>(this->max_bath_temperature_received_hex_ / 18) ==
+           static_cast<int>(std::round(p->max_bath_temperature));
+  case PROFILE_HUMIDITY: {
+    const uint32_t data = this->humidity_received_hex_;
+    if (!std::isnan(p->humidity_step)) {
+      int step = (static_cast<int>((data >> 4) & 0xFF) - HUM_STEP_BASE) /
+                 HUM_STEP_SCALE;
+      step = std::max(0, std::min(10, step));
+      return (data & 0xF0000000) == 0 &&
+             step == static_cast<int>(std::lround(p->humidity_step));
+    }
+    const int target =
+        std::min(63, static_cast<int>(std::lround(p->humidity_percent)));
+    return (data & 0xF0000000) != 0 &&
+           static_cast<int>((data >> 7) & 0x3F) == target;
+  }
+  case PROFILE_HEATER:
+    return this->last_heater_on_ == (p->heater == 1);
+  default:
+    return true;
+  }
+}
+
+// RX task, after the frame has been decoded: the release orders the
+// received value before the bit loop() acts on
+void SAUNA360Component::mark_profile_seen_(uint16_t code) {
+  uint8_t field;
+  switch (code) {
+  case 0x6000:
+    field = PROFILE_TEMPERATURE;
+    break;
+  case 0x4002:
+    field = PROFILE_BATH_TIME | PROFILE_MAX_TEMPERATURE;
+    break;
+  case 0x6001:
+    field = PROFILE_HUMIDITY;
+    break;
+  case 0x7180:
+    field = PROFILE_HEATER;
+    break;
+  default:
+    return;
+  }
+  this->profile_seen_.fetch_or(field, std::memory_order_release);
+}
+
+void SAUNA360Component::check_profile_confirmed_(uint32_t now) {
+  const uint32_t elapsed = now - this->profile_applied_ms_;
+  const uint8_t seen = this->profile_seen_.load(std::memory_order_acquire);
+  bool confirmed = (seen & this->profile_fields_) == this->profile_fields_;
+  for (uint8_t bit = 1; confirmed && bit <= PROFILE_HEATER; bit <<= 1) {
+    if ((this->profile_fields_ & bit) && !this->profile_field_matches_(bit))
+      confirmed = false;
+  }
+  if (!confirmed) {
+    if (elapsed > PROFILE_CONFIRM_TIMEOUT_MS) {
+      ESP_LOGW(TAG, "Bath profile '%s' not confirmed by heater within %u ms",
+               this->pending_profile_->name.c_str(),
+               (unsigned)PROFILE_CONFIRM_TIMEOUT_MS);
+      this->pending_profile_ = nullptr;
+    }
+    return;
+  }
+
+  ESP_LOGI(TAG, "Bath profile '%s' confirmed by heater after %u ms",
+           this->pending_profile_->name.c_str(), (unsigned)elapsed);
+  for (auto &listener : listeners_)
+    listener->on_profile_apply_time(elapsed);
+  this->pending_profile_ = nullptr;
+}
+
+uint32_t SAUNA360Component::bus_timeout_ms_() const {
+  const uint32_t cycle =
+      (this->bus_cycle_ms_ != 0) ? this->bus_cycle_ms_ : BUS_CYCLE_DEFAULT_MS;
+  return std::max(BUS_TIMEOUT_MIN_MS, cycle * this->bus_timeout_cycles_);
+}
+
+void SAUNA360Component::check_bus_watchdog_(uint32_t now) {
+  const uint32_t last = this->last_frame_ms_;
+  // last may be a tick ahead of now (written by the RX task)
+  const bool silent =
+      (last == 0) ||
+      static_cast<int32_t>(now - last) >
+          static_cast<int32_t>(this->bus_timeout_ms_());
+
+  if (!silent && this->bus_state_ != BusState::UP) {
+    ESP_LOGI(TAG, "Bus available%s",
+             this->bus_state_ == BusState::DOWN ? " again" : "");
+    this->bus_state_ = BusState::UP;
+    this->status_clear_warning();
+    for (auto &l : listeners_) {
+      l->on_bus_available(true);
+      l->on_ready_status(true);
+    }
+  } else if (silent && this->bus_state_ == BusState::UP) {
+    ESP_LOGW(TAG,
+             "Bus silent for %u ms (cycle %u ms, %u missed): marking "
+             "unavailable, TX paused",
+             (unsigned)(now - last), (unsigned)this->bus_cycle_ms_,
+             (unsigned)this->bus_timeout_cycles_);
+    this->bus_state_ = BusState::DOWN;
+    this->status_set_warning("RS485 bus silent");
+    // Stale commands must not fire when the heater comes back
+    this->flush_tx_queue_();
+    for (auto &l : listeners_) {
+      l->on_bus_available(false);
+      // The sensor now shows NAN; republish even an unchanged setpoint
+      l->current_target_temperature = -1;
+    }
+#ifdef USE_NUMBER
+    for (number::Number *n :
+         {this->bath_time_number_, this->bath_temperature_number_,
+          this->max_bath_temperature_number_, this->humidity_step_number_,
+          this->humidity_percent_number_}) {
+      if (n != nullptr)
+        n->publish_state(NAN);
+    }
+#endif
+    this->humidity_step_published_ = false;
+    this->humidity_percent_published_ = false;
+    this->heater_state_ = nullptr;
+    this->anomaly_.reset();
+#ifdef SAUNA360_CUSTOM_REGISTERS
+    this->custom_.invalidate();
+#endif
+  }
+}
+
+#ifdef SAUNA360_CUSTOM_REGISTERS
+void SAUNA360Component::add_custom_field(uint8_t direction, uint16_t code,
+                                         uint8_t bit_offset, uint8_t bit_width,
+                                         bool is_signed, float scale,
+                                         float offset, CustomFieldSink *sink) {
+  if (!this->custom_.add(direction, code, bit_offset, bit_width, is_signed,
+                         scale, offset, sink))
+    ESP_LOGW(TAG, "Custom register %04X ignored, max %u fields", code,
+             (unsigned)CustomRegisters::MAX_FIELDS);
+}
+#endif
+
+void SAUNA360Component::dump_registers() {
+  const uint32_t now = millis();
+  ESP_LOGI(TAG, "Register map: %u codes (capacity %u, dropped %u)",
+           (unsigned)this->registers_.size(),
+           (unsigned)RegisterMap::CAPACITY,
+           (unsigned)this->registers_.dropped());
+  for (uint16_t i = 0; i < RegisterMap::CAPACITY; i++) {
+    const RegisterMap::Entry &e = this->registers_.slot(i);
+    if (e.key == RegisterMap::EMPTY_KEY)
+      continue;
+    ESP_LOGI(TAG,
+             "  %s %04X = 0x%08X changed=0x%08X frames=%u changes=%u "
+             "first=%us last=%us ago",
+             e.direction() == RegisterMap::HEATER_TO_PANEL ? "H->P" : "P->H",
+             e.code(), (unsigned)e.value, (unsigned)e.changed_bits,
+             (unsigned)e.frames, (unsigned)e.changes,
+             (unsigned)(e.first_ms / 1000u),
+             (unsigned)((now - e.last_ms) / 1000u));
+  }
+}
+
+void SAUNA360Component::add_discovery_code(uint16_t code) {
+  if (this->discovery_ == nullptr)
+    this->discovery_ = new BitDiscovery(); // NOLINT
+  if (!this->discovery_->add_code(code))
+    ESP_LOGW(TAG, "Discovery: code %04X ignored, max %u codes", code,
+             (unsigned)BitDiscovery::MAX_CODES);
+}
+
+void SAUNA360Component::set_discovery_window(uint32_t ms) {
+  if (this->discovery_ != nullptr)
+    this->discovery_->set_window_ms(ms);
+}
+
+void SAUNA360Component::discovery_report() {
+  if (this->discovery_ == nullptr) {
+    ESP_LOGW(TAG, "Discovery mode is not enabled");
+    return;
+  }
+  this->discovery_->log_report(TAG);
+}
+
+#ifdef SAUNA360_BENCHMARK
+// Heater -> panel registers as last seen on the bus. Door frames are left
+// out: replaying a door alarm would queue an acknowledgement per frame.
+// Without a heater the handled codes are replayed with zero data.
+void SAUNA360Component::load_benchmark_frames_() {
+  static constexpr uint16_t SYNTHETIC_CODES[] = {
+      0x3400, 0x4002, 0x4003, 0x4200, 0x6000, 0x6001,
+      0x7180, 0x7280, 0x9000, 0x9400, 0x9401,
+  };
+  this->bench_.clear_frames();
+  for (uint16_t i = 0; i < RegisterMap::CAPACITY; i++) {
+    const RegisterMap::Entry &e = this->registers_.slot(i);
+    if (e.key == RegisterMap::EMPTY_KEY ||
+        e.direction() != RegisterMap::HEATER_TO_PANEL || e.code() == 0xB000)
+      continue;
+    if (!this->bench_.add_frame(0x06, e.code(), e.value))
+      break;
+  }
+  if (this->bench_.frame_count() != 0)
+    return;
+  for (uint16_t code : SYNTHETIC_CODES)
+    this->bench_.add_frame(0x06, code, 0);
+}
+
+void SAUNA360Component::benchmark(uint32_t start_rate, uint32_t max_rate,
+                                  uint32_t step_ms) {
+  if (this->bench_.running()) {
+    ESP_LOGW(TAG, "Benchmark already running");
+    return;
+  }
+  // The heater would lose its panel for the whole run
+  if (this->virtual_panel_) {
+    ESP_LOGW(TAG, "Benchmark not available with the virtual panel");
+    return;
+  }
+  this->load_benchmark_frames_();
+  if (!this->bench_.request(start_rate, max_rate, step_ms))
+    return;
+  ESP_LOGI(TAG,
+           "Benchmark: %u frame types, %u..%u frames/s, %u ms per step; "
+           "bus paused",
+           (unsigned)this->bench_.frame_count(), (unsigned)start_rate,
+           (unsigned)max_rate, (unsigned)step_ms);
+  this->bus_.wake();
+}
+
+// RX task, between two reads
+void SAUNA360Component::run_benchmark_() {
+  // A frame cut short by the benchmark is dropped
+  this->frame_flag_ = false;
+  this->rx_len_ = 0;
+  this->bench_injecting_ = true;
+  this->bench_.run(
+      [](void *ctx, const uint8_t *frame, size_t len) {
+        auto *self = static_cast<SAUNA360Component *>(ctx);
+        self->rx_byte_us_ = micros();
+        for (size_t i = 0; i < len; i++)
+          self->handle_byte_(frame[i]);
+      },
+      this);
+  this->bench_injecting_ = false;
+  this->frame_flag_ = false;
+  this->rx_len_ = 0;
+  // What arrived meanwhile is stale; its TX slots are long gone
+  this->bus_.flush_input();
+}
+
+void SAUNA360Component::benchmark_loop_() {
+  if (this->bench_.running())
+    this->bench_.on_loop(micros());
+  if (!this->bench_.take_result())
+    return;
+  this->bench_.log_result(TAG);
+  for (auto &listener : listeners_)
+    listener->on_benchmark(this->bench_);
+}
+#endif
+
 void SAUNA360Component::dump_config() {
+#ifdef USE_HOST
+  ESP_LOGCONFIG(TAG, "Bus device: %s", this->bus_.device());
+#elif defined(SAUNA360_RX_DMA)
+  ESP_LOGCONFIG(TAG, "UART component, RX/TX through UHCI DMA");
+#else
   ESP_LOGCONFIG(TAG, "UART component");
+#endif
+#ifdef SAUNA360_MODEL_AUTO
+  if (this->model_known_) {
+    ESP_LOGCONFIG(TAG, "Model: %s (auto, detected after %u ms)",
+                  model_name(this->model_.model),
+                  (unsigned)this->detector_.detection_ms());
+  } else {
+    ESP_LOGCONFIG(TAG, "Model: auto, detecting (%u heater cycles)",
+                  (unsigned)this->detector_.cycles_seen());
+  }
+#else
+  ESP_LOGCONFIG(TAG, "Model: %s (%s)", model_name(this->model_.model),
+                ModelPolicy::FIXED ? "compile-time" : "runtime");
+#endif
   ESP_LOGCONFIG(TAG, "Session timer: enabled");
+  if (this->virtual_panel_) {
+    ESP_LOGCONFIG(TAG, "Virtual panel: replying %u us after heater polls",
+                  (unsigned)VIRTUAL_PANEL_REPLY_US);
+  } else {
+    ESP_LOGCONFIG(TAG, "TX delay: %d us (%s)", this->min_ifg_us_,
+                  this->adaptive_ifg_ ? "adaptive" : "fixed");
+  }
+  if (this->arbiter_.node_id() != 0)
+    ESP_LOGCONFIG(TAG, "Arbitration: node %u, +%u us after panel EOF",
+                  (unsigned)this->arbiter_.node_id(),
+                  (unsigned)this->arbiter_.slot_offset_us());
+#ifdef SAUNA360_RS485
+  ESP_LOGCONFIG(TAG, "RS485 collision detect: DE on GPIO%d, %u retries",
+                this->bus_.de_pin(), (unsigned)this->arbiter_.max_retries());
+#endif
+  ESP_LOGCONFIG(TAG, "Bus watchdog: %u missed cycles",
+                (unsigned)this->bus_timeout_cycles_);
+#ifdef SAUNA360_CUSTOM_REGISTERS
+  for (uint8_t i = 0; i < this->custom_.size(); i++) {
+    const CustomRegisters::Field &f = this->custom_.field(i);
+    ESP_LOGCONFIG(TAG, "Custom register: %s %04X bits %u..%u%s x%g %+g",
+                  (f.key >> 16) ? "P->H" : "H->P", (unsigned)(f.key & 0xFFFF),
+                  (unsigned)f.bit_offset,
+                  (unsigned)(f.bit_offset + f.bit_width - 1),
+                  f.is_signed ? " signed" : "", f.scale, f.offset);
+  }
+#endif
+#ifdef SAUNA360_FRAME_STREAM
+  ESP_LOGCONFIG(TAG, "Frame stream: TCP port %u",
+                (unsigned)this->stream_.port());
+#endif
+#ifdef SAUNA360_JOURNAL
+  if (this->journal_.ready()) {
+    ESP_LOGCONFIG(TAG, "Session journal: '%s', %u of %u slots used",
+                  this->journal_.partition_label(),
+                  (unsigned)this->journal_.count(),
+                  (unsigned)this->journal_.slots());
+  } else {
+    ESP_LOGCONFIG(TAG, "Session journal: partition '%s' unavailable",
+                  this->journal_.partition_label());
+  }
+#endif
+#ifdef SAUNA360_FLIGHT_RECORDER
+  if (this->recorder_.ready()) {
+    ESP_LOGCONFIG(TAG,
+                  "Flight recorder: %u records in %s, -%u/+%u ms, '%s' "
+                  "%u of %u slots used",
+                  (unsigned)this->recorder_.records(),
+                  this->recorder_.in_psram() ? "PSRAM" : "internal RAM",
+                  (unsigned)this->recorder_.pre_ms(),
+                  (unsigned)this->recorder_.post_ms(),
+                  this->recorder_.partition_label(),
+                  (unsigned)this->recorder_.count(),
+                  (unsigned)this->recorder_.slots());
+  } else {
+    ESP_LOGCONFIG(TAG, "Flight recorder: unavailable (partition '%s')",
+                  this->recorder_.partition_label());
+  }
+#endif
+#ifdef SAUNA360_CYCLE_LEARNER
+  if (this->cycles_.locked()) {
+    ESP_LOGCONFIG(TAG,
+                  "Cycle learner: %u events, %u windows, period %u us, "
+                  "window error avg %u us",
+                  (unsigned)this->cycles_.events(),
+                  (unsigned)this->cycles_.windows(),
+                  (unsigned)this->cycles_.period_us(),
+                  (unsigned)this->cycles_.error_avg_us());
+  } else {
+    ESP_LOGCONFIG(TAG, "Cycle learner: learning");
+  }
+#endif
+  ESP_LOGCONFIG(TAG, "RX task stack: %u bytes, TX queue: %u frames",
+                (unsigned)SAUNA360_RX_STACK_SIZE, (unsigned)TX_QUEUE_LEN);
+#ifdef SAUNA360_HEAP_AUDIT
+  ESP_LOGCONFIG(TAG, "Heap audit: enabled");
+#endif
+  ESP_LOGCONFIG(TAG, "Power save: %s%s", this->power_save_ ? "on" : "off",
+                this->power_save_ && this->pm_.light_sleep()
+                    ? " (light sleep)"
+                    : "");
 }
 
 } // namespace sauna360
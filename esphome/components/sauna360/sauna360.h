@@ -1,8 +1,30 @@
 #pragma once
 
-#include "esphome/components/uart/uart.h"
 #include "esphome/core/component.h"
+#include "esphome/core/defines.h"
 #include "esphome/core/helpers.h"
+#ifndef USE_HOST
+#include "esphome/components/uart/uart.h"
+#endif
+#include "anomaly_detector.h"
+#include "benchmark.h"
+#include "bit_discovery.h"
+#include "bus_port.h"
+#include "custom_register.h"
+#include "cycle_learner.h"
+#include "flight_recorder.h"
+#include "frame_stream.h"
+#include "heap_audit.h"
+#include "ifg_calibrator.h"
+#include "latency_stats.h"
+#include "model_detector.h"
+#include "model_policy.h"
+#include "power_manager.h"
+#include "register_map.h"
+#include "sauna360_protocol.h"
+#include "session_journal.h"
+#include "tx_arbiter.h"
+
 
 #ifdef USE_SENSOR
 #include "esphome/components/sensor/sensor.h"
@@ -26,11 +48,17 @@
 #include "esphome/components/datetime/datetime_entity.h"
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <queue>
 #include <string>
 #include <vector>
 
+// Sized from YAML (tx_queue_size)
+#ifndef SAUNA360_TX_QUEUE_LEN
+#define SAUNA360_TX_QUEUE_LEN 16
+#endif
+
 namespace esphome {
 namespace sauna360 {
 
@@ -44,19 +72,53 @@ public:
   virtual void on_max_bath_temperature(uint16_t) {};
   virtual void on_overheating_pcb_limit(uint16_t) {};
   virtual void on_heater_status(bool) {};
-  virtual void on_heater_state(const std::string &state) {};
+  virtual void on_heater_state(const char *state) {};
   virtual void on_light_status(bool) {};
   virtual void on_ready_status(bool) {};
+  virtual void on_bus_available(bool) {};
   virtual void on_setting_humidity_step(uint16_t) {};
   virtual void on_setting_humidity_percent(uint16_t) {};
   virtual void on_water_tank_level(uint16_t) {};
   virtual void on_session_uptime(uint32_t) {};
   virtual void on_session_uptime_text(const std::string &) {};
   virtual void on_coils_active(uint8_t) {};
+  virtual void on_profile_apply_time(uint32_t) {};
+  virtual void on_tx_delay(uint32_t) {};
+  virtual void on_ifg_histogram(const char *) {};
+  virtual void on_cpu_frequency(uint32_t) {};
+  virtual void on_wake_count(uint32_t) {};
+  virtual void on_dropped_frames(uint32_t) {};
+  virtual void on_rx_stack_free(uint32_t) {};
+  virtual void on_loop_stack_free(uint32_t) {};
+  virtual void on_latency(const LatencyMonitor &) {};
+  virtual void on_arbitration(const TxArbiter &) {};
+  virtual void on_anomaly(AnomalyDetector::Reason, const char *) {};
+  virtual void on_stream_dropped(uint32_t) {};
+  virtual void on_benchmark(const Benchmark &) {};
+  virtual void on_cycle_learner(const CycleLearner &) {};
+  // model: auto; also when a later frame revises the model
+  virtual void on_model_detected(Model, uint32_t detection_ms) {};
   int current_target_temperature = -1;
 };
 
+// Named bath profile. NAN / -1 fields are left untouched when applied.
+struct SAUNA360Profile {
+  std::string name;
+  float bath_temperature{NAN};
+  float bath_time{NAN};
+  float max_bath_temperature{NAN};
+  float humidity_step{NAN};
+  float humidity_percent{NAN};
+  int8_t heater{-1}; // -1 = keep, 0 = off, 1 = on
+};
+
+// On ESP32 the uart: component sets up UART0; host builds open the bus
+// device directly (BusPort)
+#ifdef USE_HOST
+class SAUNA360Component : public Component {
+#else
 class SAUNA360Component : public uart::UARTDevice, public Component {
+#endif
 
 #ifdef USE_NUMBER
   SUB_NUMBER(bath_time)
@@ -72,8 +134,42 @@ class SAUNA360Component : public uart::UARTDevice, public Component {
 #endif
 
 public:
-  enum class Mode : uint8_t { PURE = 0, COMBI = 1, ELITE = 2, COMBI_ELITE = 3 };
-  void set_mode(Mode m) { mode_ = m; }
+  using Mode = Model;
+#ifdef SAUNA360_MODEL_FIXED
+  void set_mode(Mode) {} // fixed at compile time by codegen
+#else
+  void set_mode(Mode m) { model_.select(m); }
+#endif
+#ifdef SAUNA360_MODEL_AUTO
+  void set_detection_cycles(uint8_t cycles) { detector_.set_cycles(cycles); }
+#endif
+  void set_adaptive_ifg(bool enable) { adaptive_ifg_ = enable; }
+  void set_virtual_panel(bool enable) { virtual_panel_ = enable; }
+  void set_anomaly_detection(uint32_t stuck_ms, uint32_t min_coil_period_ms) {
+    anomaly_enabled_ = true;
+    anomaly_.set_stuck_ms(stuck_ms);
+    anomaly_.set_min_coil_period_ms(min_coil_period_ms);
+  }
+  void set_arbitration(uint8_t node_id, uint32_t slot_spacing_us) {
+    arbiter_.set_node(node_id, slot_spacing_us);
+  }
+#ifdef USE_HOST
+  void set_bus_device(const char *path) { bus_.set_device(path); }
+#endif
+#ifdef SAUNA360_RS485
+  void set_rs485(int de_pin, uint8_t max_retries) {
+    bus_.set_de_pin(de_pin);
+    arbiter_.set_max_retries(max_retries);
+  }
+#endif
+  void set_bus_timeout_cycles(uint8_t cycles) { bus_timeout_cycles_ = cycles; }
+  void set_power_save(uint16_t min_freq_mhz, bool light_sleep,
+                      uint32_t quiet_ms) {
+    power_save_ = true;
+    pm_.set_min_freq_mhz(min_freq_mhz);
+    pm_.set_light_sleep(light_sleep);
+    pm_.set_quiet_ms(quiet_ms);
+  }
 
   void setup() override;
   void loop() override;
@@ -95,10 +191,11 @@ public:
     max_bath_temperature_default_ = v;
   }
 
-  void set_humidity_step_number(float value);
+  // False if the model has no such control and nothing was queued
+  bool set_humidity_step_number(float value);
   void set_humidity_step_default_value(float v) { humidity_step_default_ = v; }
 
-  void set_humidity_percent_number(float value);
+  bool set_humidity_percent_number(float value);
   void set_humidity_percent_default_value(float v) {
     humidity_percent_default_ = v;
   }
@@ -106,6 +203,60 @@ public:
   void set_light_relay(bool enable);
   void set_heater_relay(bool enable);
 
+  void add_profile(const std::string &name, float bath_temperature,
+                   float bath_time, float max_bath_temperature,
+                   float humidity_step, float humidity_percent, int heater);
+  bool apply_profile(const std::string &name);
+
+  void dump_registers();
+
+  void add_discovery_code(uint16_t code);
+  void set_discovery_window(uint32_t ms);
+  void discovery_report();
+  void reset_latency() { latency_.reset(); }
+
+#ifdef SAUNA360_FRAME_STREAM
+  void set_frame_stream_port(uint16_t port) { stream_.set_port(port); }
+#endif
+#ifdef SAUNA360_JOURNAL
+  void set_journal_partition(const char *label) {
+    journal_.set_partition_label(label);
+  }
+#endif
+  // Session journal readout (log) and wipe; no-ops without journal:
+  void journal_dump();
+  void journal_clear();
+#ifdef SAUNA360_FLIGHT_RECORDER
+  void set_flight_recorder(const char *label, uint32_t records,
+                           uint32_t pre_ms, uint32_t post_ms) {
+    recorder_.set_partition_label(label);
+    recorder_.set_records(records);
+    recorder_.set_windows(pre_ms, post_ms);
+  }
+  void add_recorder_code(uint16_t code) { recorder_.add_code(code); }
+  void set_recorder_crc_burst(uint8_t count, uint32_t window_ms) {
+    recorder_.set_crc_burst(count, window_ms);
+  }
+  void set_recorder_heater_state(bool enable) {
+    recorder_.set_heater_state_trigger(enable);
+  }
+#endif
+  // Flight recorder captures to the log, and a manual trigger; no-ops
+  // without flight_recorder:
+  void recorder_dump();
+  void recorder_trigger();
+#ifdef SAUNA360_BENCHMARK
+  // Pauses the bus and replays heater frames on the RX task, from
+  // `start_rate` frames/s doubling up to `max_rate`; results in loop()
+  void benchmark(uint32_t start_rate, uint32_t max_rate, uint32_t step_ms);
+#endif
+#ifdef SAUNA360_CUSTOM_REGISTERS
+  // direction: RegisterMap::Direction
+  void add_custom_field(uint8_t direction, uint16_t code, uint8_t bit_offset,
+                        uint8_t bit_width, bool is_signed, float scale,
+                        float offset, CustomFieldSink *sink);
+#endif
+
   void process_heater_status(uint32_t data);
   void process_bath_time(uint32_t data);
   void process_pcb_limit(uint32_t data);
@@ -122,25 +273,170 @@ public:
   void process_time_limit(uint32_t data);
 
 protected:
-  Mode mode_ = Mode::PURE;
+  ModelPolicy model_;
+#ifdef SAUNA360_MODEL_AUTO
+  // Detection runs on the RX task and switches model_ there, before the
+  // frame is decoded; loop() applies the TX delay and reports it
+  ModelDetector detector_;
+  volatile bool model_known_{false};
+  volatile bool model_changed_{false};
+  void model_loop_();
+#endif
   esphome::HighFrequencyLoopRequester high_freq_;
   int min_ifg_us_ = 520;
-  uint32_t LIGHT_MASK_{0x00020000};
-  uint32_t COILS_MASK_{0x0001C000};
-  int COILS_SHIFT_{14};
+  bool adaptive_ifg_{false};
+  // Virtual panel: answer heater polls ourselves (no physical panel)
+  static constexpr uint32_t VIRTUAL_PANEL_REPLY_US = 600;
+  static constexpr uint32_t OWN_ECHO_WINDOW_US = 20000;
+  volatile bool virtual_panel_{false};
+  volatile bool foreign_panel_{false}; // set by the RX task
+  bool foreign_panel_logged_{false};
+  uint32_t last_tx_us_{0};
+  void answer_poll_(uint32_t poll_us);
+  void handle_slot_(bool panel_eof, bool more, uint32_t end_us);
+#ifdef SAUNA360_RX_DMA
+  bool handle_dma_frame_(const uint8_t *buf, size_t len, uint32_t end_us);
+#endif
+  TxArbiter arbiter_;
+#ifdef SAUNA360_CYCLE_LEARNER
+  CycleLearner cycles_;
+  uint32_t cycle_lock_logged_{0};
+  // Air time of the batch at the head of the TX queue, IFG included
+  uint32_t head_batch_airtime_us_() const;
+#endif
+  uint32_t abandoned_logged_{0};
+  bool anomaly_enabled_{false};
+  AnomalyDetector anomaly_;
+  void publish_anomalies_();
+  IFGCalibrator ifg_;
+  uint32_t last_ifg_eval_ms_{0};
+  uint32_t ifg_collisions_seen_{0};
+  static constexpr uint32_t IFG_EVAL_INTERVAL_MS = 10000;
+  bool power_save_{false};
+  PowerManager pm_;
+  void update_power_state_(uint32_t now);
+
+  uint32_t last_diag_pub_ms_{0};
+  static constexpr uint32_t DIAG_PUBLISH_INTERVAL_MS = 60000;
+  volatile uint32_t dropped_frames_{0};
+  void publish_diagnostics_();
+
+  // Pipeline timestamps (micros()), all recorded on the RX task
+  LatencyMonitor latency_;
+  uint32_t rx_byte_us_{0};
+  uint32_t rx_valid_us_{0};
+#ifdef SAUNA360_HEAP_AUDIT
+  uint32_t audit_rx_allocs_{0};
+  uint32_t audit_loop_allocs_{0};
+  bool audit_warm_{false};
+#endif
 
   std::vector<SAUNA360Listener *> listeners_{};
-  std::vector<uint8_t> rx_message_;
-  std::queue<std::vector<uint8_t>> tx_queue_;
+  RegisterMap registers_;
+#ifdef SAUNA360_CUSTOM_REGISTERS
+  CustomRegisters custom_;
+#endif
+#ifdef SAUNA360_FRAME_STREAM
+  FrameStream stream_;
+#endif
+#ifdef SAUNA360_FLIGHT_RECORDER
+  static constexpr uint32_t RECORDER_DUMP_PER_LOOP = 16;
+  FlightRecorder recorder_;
+  bool recorder_dumping_{false};
+  uint32_t recorder_dump_slot_{0};
+  uint32_t recorder_dump_pos_{0};
+  uint32_t recorder_dump_count_{0}; // records in the slot being dumped
+  void recorder_snapshot_();
+  void recorder_loop_();
+#endif
+  // RX task: every frame seen or sent, to the stream and the recorder
+  void capture_(const uint8_t *data, size_t len, uint8_t flags,
+                uint32_t time_us) {
+#ifdef SAUNA360_FRAME_STREAM
+    this->stream_.push(data, len, flags, time_us);
+#endif
+#ifdef SAUNA360_FLIGHT_RECORDER
+    this->recorder_.record(data, len, flags, time_us);
+#endif
+  }
+#ifdef SAUNA360_BENCHMARK
+  Benchmark bench_;
+  bool bench_injecting_{false}; // RX task
+  void load_benchmark_frames_();
+  void run_benchmark_();
+  void benchmark_loop_();
+#endif
+  // RX task: the frame being decoded was injected by the benchmark. Those
+  // run the decode and publish path (custom registers included) only; the
+  // register map, watchdog cadence, latency, model detector, cycle learner,
+  // arbiter, bit discovery, anomaly detector, journal, capture, flight
+  // recorder and profile tracking skip them. last_frame_ms_ is still
+  // refreshed: the bus is paused by us, not down.
+  bool injecting_() const {
+#ifdef SAUNA360_BENCHMARK
+    return this->bench_injecting_;
+#else
+    return false;
+#endif
+  }
+  BitDiscovery *discovery_{nullptr};
+  void discovery_event_(BitDiscovery::Event event) {
+    if (this->discovery_ != nullptr && !this->injecting_())
+      this->discovery_->on_event(event, millis());
+  }
+  // Raw frame being received (RX task only)
+  static constexpr uint8_t RX_BUF_LEN = protocol::MAX_FRAME_LEN;
+  uint8_t rx_buf_[RX_BUF_LEN];
+  uint8_t rx_len_{0};
 
-  uint8_t decode_escape_sequence(uint8_t data);
-  bool validate_packet(std::vector<uint8_t> &packet);
+  bool validate_packet(const uint8_t *packet, size_t len);
   void handle_byte_(uint8_t byte);
-  void handle_packet_(std::vector<uint8_t> packet);
-  void handle_frame_(const std::vector<uint8_t> &frame);
-  void send_data_();
+  void handle_packet_(const uint8_t *packet, size_t len);
+  bool handle_frame_(const uint8_t *frame, size_t len);
+  void handle_rx_frame_(const uint8_t *frame, size_t len);
+  void send_data_(uint32_t slot_us);
   void create_send_data_(uint8_t type, uint16_t code, uint32_t data);
 
+  // Encoded TX frames. Fixed ring: producers (main loop, RX task for door
+  // acks) append under tx_lock_, the RX task consumes after a panel EOF.
+  struct TxFrame {
+    uint8_t len{0};
+    bool more{false}; // next frame belongs to the same bus window
+    uint8_t tries{0};  // collisions so far (rs485)
+    uint32_t created_us{0};
+    uint32_t queued_us{0};
+    uint8_t data[protocol::MAX_FRAME_LEN];
+  };
+  static constexpr uint8_t TX_QUEUE_LEN = SAUNA360_TX_QUEUE_LEN; // 2^n
+  static_assert((TX_QUEUE_LEN & (TX_QUEUE_LEN - 1)) == 0 &&
+                    TX_QUEUE_LEN <= 128,
+                "TX queue length must be a power of two <= 128");
+  static constexpr uint8_t TX_BATCH_MAX = 8;
+  TxFrame tx_queue_[TX_QUEUE_LEN];
+  std::atomic<uint8_t> tx_head_{0};
+  std::atomic<uint8_t> tx_tail_{0};
+  // Set by flush_tx_queue_(); the RX task, which owns tx_head_, drops the
+  // queue before its next slot
+  std::atomic<bool> tx_flush_{false};
+  Mutex tx_lock_;
+  BusPort bus_;
+
+  bool tx_pending_() const {
+    return this->tx_head_.load(std::memory_order_relaxed) !=
+           this->tx_tail_.load(std::memory_order_acquire);
+  }
+  bool push_tx_frames_(TxFrame *frames, uint8_t count);
+
+  // TX batching: frames created between begin/commit go out back-to-back in
+  // a single bus window and cannot be interleaved with other commands.
+  bool tx_batch_open_{false};
+  TxFrame tx_batch_[TX_BATCH_MAX];
+  uint8_t tx_batch_len_{0};
+  void begin_tx_batch_();
+  void commit_tx_batch_();
+
+  void queue_bath_time_(int target_minutes, float max_bath_temperature);
+
   uint32_t temperature_received_hex_{0};
   uint32_t setpoint_temperature_received_hex_{0};
   uint32_t bath_time_received_hex_{0};
@@ -157,6 +453,8 @@ protected:
   static constexpr int HUM_STEP_SCALE = 8;
 
   bool frame_flag_{false};
+  const char *heater_state_{nullptr}; // last published, a string literal
+  void publish_heater_state_(const char *state);
   bool state_changed_{false};
   bool heating_status_{false};
   bool defaults_initialized_{false};
@@ -186,6 +484,68 @@ protected:
   uint32_t last_session_pub_ms_{0};
 
   void publish_session_();
+
+#ifdef SAUNA360_JOURNAL
+  // Session record built on the RX task; a finished one is handed to loop()
+  // for the flash write
+  static constexpr uint32_t JOURNAL_DUMP_PER_LOOP = 16;
+  SessionJournal journal_;
+  SessionJournal::Record journal_rec_{};
+  SessionJournal::Record journal_done_{};
+  volatile bool journal_done_pending_{false};
+  uint32_t journal_temp_sum_{0};
+  uint32_t journal_temp_n_{0};
+  uint16_t journal_peak_raw_{0};
+  bool journal_coils_on_{false};
+  uint32_t journal_coils_since_ms_{0};
+  uint32_t journal_coil_ms_{0};
+  uint8_t journal_end_hint_{SessionJournal::END_UNKNOWN};
+  bool journal_dumping_{false};
+  uint32_t journal_dump_pos_{0};
+  void journal_begin_();
+  void journal_end_();
+  void journal_coils_(bool on);
+  void journal_loop_();
+#endif
+
+  // Bus-silence watchdog. The heater cadence is learned from the interval
+  // between 0x6000 broadcasts; the bus is declared lost after
+  // bus_timeout_cycles_ missed cycles.
+  enum class BusState : uint8_t { UNKNOWN, UP, DOWN };
+  static constexpr uint32_t BUS_CYCLE_DEFAULT_MS = 2000;
+  static constexpr uint32_t BUS_TIMEOUT_MIN_MS = 500;
+  BusState bus_state_{BusState::UNKNOWN};
+  uint8_t bus_timeout_cycles_{3};
+  volatile uint32_t last_frame_ms_{0};
+  uint32_t last_cycle_frame_ms_{0};
+  uint32_t bus_cycle_ms_{0};
+
+  uint32_t bus_timeout_ms_() const;
+  void check_bus_watchdog_(uint32_t now);
+  void flush_tx_queue_();
+
+  // Bath profiles
+  enum ProfileField : uint8_t {
+    PROFILE_TEMPERATURE = 1 << 0,
+    PROFILE_BATH_TIME = 1 << 1,
+    PROFILE_MAX_TEMPERATURE = 1 << 2,
+    PROFILE_HUMIDITY = 1 << 3,
+    PROFILE_HEATER = 1 << 4,
+  };
+  static constexpr uint32_t PROFILE_CONFIRM_TIMEOUT_MS = 30000;
+  static constexpr int BATH_TIME_SNAP_TOL_MIN = 8;
+
+  // The RX task only marks which fields the heater has reported since the
+  // apply; matching, confirmation and the timeout run in loop()
+  std::vector<SAUNA360Profile> profiles_{};
+  const SAUNA360Profile *pending_profile_{nullptr};
+  uint8_t profile_fields_{0};
+  std::atomic<uint8_t> profile_seen_{0};
+  uint32_t profile_applied_ms_{0};
+
+  bool profile_field_matches_(uint8_t field) const;
+  void mark_profile_seen_(uint16_t code); // RX task
+  void check_profile_confirmed_(uint32_t now);
 };
 
 } // namespace sauna360
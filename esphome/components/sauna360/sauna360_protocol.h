@@ -0,0 +1,180 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Wire format shared by the component and host tools. No ESPHome / ESP-IDF
+// dependencies on purpose.
+//
+//   98 | 40 <type> <code:2> <data:4> <crc:2> | 9C
+//
+// CRC-16 (poly 0x90D9, init 0xFFFF, MSB first) covers 40..data. Inside the
+// frame 0x98, 0x9C and 0x91 are sent as 0x91 followed by the inverted byte.
+
+namespace esphome {
+namespace sauna360 {
+namespace protocol {
+
+static constexpr uint8_t SOF = 0x98;
+static constexpr uint8_t EOF_BYTE = 0x9C;
+static constexpr uint8_t ESC = 0x91;
+static constexpr uint8_t ADDRESS = 0x40;
+
+static constexpr uint16_t CRC_INIT = 0xFFFF;
+static constexpr uint16_t CRC_POLY = 0x90D9;
+
+// Heater's poll, and the panel's plain answer to it
+static constexpr uint8_t HEATER_POLL[6] = {0x98, 0x40, 0x06, 0x6D, 0x3A, 0x9C};
+static constexpr uint8_t PANEL_ACK[6] = {0x98, 0x40, 0x07, 0xFD, 0xE3, 0x9C};
+
+// address, type, code (2), data (4)
+static constexpr size_t PAYLOAD_LEN = 8;
+// Worst case: every payload and CRC byte escaped
+static constexpr size_t MAX_FRAME_LEN = 1 + 2 * (PAYLOAD_LEN + 2) + 1;
+
+// Captured-frame record header (frame stream, flight recorder):
+//   u8 len, u8 flags (REC_*), u16 seq, u32 time_us, then len raw bytes
+static constexpr size_t REC_HEADER_LEN = 8;
+static constexpr uint8_t REC_VALID = 0x01;    // CRC ok
+static constexpr uint8_t REC_PANEL = 0x02;    // panel -> heater
+static constexpr uint8_t REC_TX = 0x04;       // sent by this node
+static constexpr uint8_t REC_TRUNC = 0x08;    // longer than the RX buffer
+static constexpr uint8_t REC_SNAPSHOT = 0x10; // decoded state, not a frame
+
+namespace detail {
+constexpr std::array<uint16_t, 256> make_crc_table() {
+  std::array<uint16_t, 256> table{};
+  for (uint16_t i = 0; i < 256; i++) {
+    uint16_t crc = static_cast<uint16_t>(i << 8);
+    for (uint8_t bit = 0; bit < 8; bit++)
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ CRC_POLY)
+                           : static_cast<uint16_t>(crc << 1);
+    table[i] = crc;
+  }
+  return table;
+}
+static constexpr std::array<uint16_t, 256> CRC_TABLE = make_crc_table();
+} // namespace detail
+
+inline uint16_t crc16_update(uint16_t crc, uint8_t b) {
+  return static_cast<uint16_t>((crc << 8) ^
+                               detail::CRC_TABLE[((crc >> 8) ^ b) & 0xFF]);
+}
+
+inline uint16_t crc16(const uint8_t *data, size_t len,
+                      uint16_t crc = CRC_INIT) {
+  while (len--)
+    crc = crc16_update(crc, *data++);
+  return crc;
+}
+
+inline bool needs_escape(uint8_t b) {
+  return b == SOF || b == EOF_BYTE || b == ESC;
+}
+
+// 0x91 0x67 -> 0x98, 0x91 0x63 -> 0x9C, 0x91 0x6E -> 0x91
+inline uint8_t escape_byte(uint8_t b) { return static_cast<uint8_t>(~b); }
+inline uint8_t unescape_byte(uint8_t b) { return static_cast<uint8_t>(~b); }
+
+inline uint8_t *put_escaped(uint8_t *out, uint8_t b) {
+  if (needs_escape(b)) {
+    *out++ = ESC;
+    *out++ = escape_byte(b);
+  } else {
+    *out++ = b;
+  }
+  return out;
+}
+
+// Encodes one complete frame (SOF .. EOF) into `out`, which must hold
+// MAX_FRAME_LEN bytes. CRC and byte stuffing are done in the same pass.
+// Returns the number of bytes written.
+inline size_t encode_frame(uint8_t type, uint16_t code, uint32_t data,
+                           uint8_t *out) {
+  const uint8_t payload[PAYLOAD_LEN] = {
+      ADDRESS,
+      type,
+      static_cast<uint8_t>(code >> 8),
+      static_cast<uint8_t>(code),
+      static_cast<uint8_t>(data >> 24),
+      static_cast<uint8_t>(data >> 16),
+      static_cast<uint8_t>(data >> 8),
+      static_cast<uint8_t>(data),
+  };
+
+  uint8_t *p = out;
+  *p++ = SOF;
+  uint16_t crc = CRC_INIT;
+  for (uint8_t b : payload) {
+    crc = crc16_update(crc, b);
+    p = put_escaped(p, b);
+  }
+  p = put_escaped(p, static_cast<uint8_t>(crc >> 8));
+  p = put_escaped(p, static_cast<uint8_t>(crc));
+  *p++ = EOF_BYTE;
+  return static_cast<size_t>(p - out);
+}
+
+// Strips SOF/EOF and byte stuffing from one raw frame (SOF .. EOF). `out`
+// must hold PAYLOAD_LEN + 2 bytes. Returns the payload length including the
+// CRC, or 0 if it does not fit. Unknown escape codes decode to ESC and are
+// left for the CRC check to reject.
+inline size_t unescape_frame(const uint8_t *frame, size_t len, uint8_t *out) {
+  size_t n = 0;
+  bool escaped = false;
+  for (size_t i = 1; i + 1 < len; i++) {
+    uint8_t b = frame[i];
+    if (b == ESC && !escaped) {
+      escaped = true;
+      continue;
+    }
+    if (escaped) {
+      b = unescape_byte(b);
+      if (!needs_escape(b))
+        b = ESC;
+      escaped = false;
+    }
+    if (n == PAYLOAD_LEN + 2)
+      return 0;
+    out[n++] = b;
+  }
+  return n;
+}
+
+// Bath time field of 0x4002 (low 12 bits) to minutes. Above 63 the encoding
+// skips 4 values per 64: raw = minutes + 4 * (minutes / 64).
+inline int bath_time_minutes(uint16_t raw12) {
+  int raw = raw12 & 0x0FFF;
+  if (raw < 64)
+    return raw;
+  int k = (raw / 64) - 1; // 0..7 for raw >= 64
+  if (k > 7)
+    k = 7;
+  int minutes = raw - 4 * (k + 1);
+  if (minutes < 0)
+    minutes = 0;
+  if (minutes > 575)
+    minutes = 575;
+  return minutes;
+}
+
+// "AA.BB.CC" into a caller buffer (3 chars per byte), truncated to fit.
+inline const char *format_hex(const uint8_t *data, size_t len, char *out,
+                              size_t out_len) {
+  static const char DIGITS[] = "0123456789ABCDEF";
+  size_t pos = 0;
+  for (size_t i = 0; i < len && pos + 3 <= out_len; i++) {
+    if (i != 0)
+      out[pos++] = '.';
+    out[pos++] = DIGITS[data[i] >> 4];
+    out[pos++] = DIGITS[data[i] & 0x0F];
+  }
+  if (out_len != 0)
+    out[pos < out_len ? pos : out_len - 1] = '\0';
+  return out;
+}
+
+} // namespace protocol
+} // namespace sauna360
+} // namespace esphome
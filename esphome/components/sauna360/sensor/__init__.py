@@ -6,9 +6,16 @@ from esphome.const import (
     DEVICE_CLASS_TEMPERATURE,
     DEVICE_CLASS_DURATION,
     DEVICE_CLASS_HUMIDITY,
+    ENTITY_CATEGORY_DIAGNOSTIC,
     STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_BYTES,
     UNIT_CELSIUS,
+    UNIT_MICROSECOND,
+    UNIT_MILLISECOND,
     UNIT_MINUTE,
+    UNIT_PERCENT,
+    UNIT_SECOND,
     ICON_THERMOMETER,
     ICON_TIMER,
 )
@@ -17,9 +24,18 @@ from .. import (
     sauna360_ns,
     SAUNA360Component,
     CONF_SAUNA360_ID,
+    CONF_CUSTOM,
+    custom_field_schema,
+    register_custom_field,
+    FEATURE_HUMIDITY_PERCENT,
+    FEATURE_HUMIDITY_STEP,
+    FEATURE_MODEL_DETECTION,
+    FEATURE_WATER_TANK,
+    model_feature_validator,
 )
 
 SAUNA360Sensor = sauna360_ns.class_("SAUNA360Sensor", sensor.Sensor, cg.Component)
+SAUNA360CustomSensor = sauna360_ns.class_("SAUNA360CustomSensor", sensor.Sensor)
 
 CONF_CURRENT_TEMPERATURE = "current_temperature"
 CONF_SETTING_TEMPERATURE = "setting_temperature"
@@ -32,6 +48,26 @@ CONF_SETTING_HUMIDITY_STEP = "setting_humidity_step"
 CONF_SETTING_HUMIDITY = "setting_humidity"
 CONF_WATER_TANK_LEVEL = "water_tank_level"
 CONF_SESSION_UPTIME = "session_uptime"
+CONF_PROFILE_APPLY_TIME = "profile_apply_time"
+CONF_TX_DELAY = "tx_delay"
+CONF_MODEL_DETECTION_TIME = "model_detection_time"
+CONF_CPU_FREQUENCY = "cpu_frequency"
+CONF_WAKE_COUNT = "wake_count"
+CONF_DROPPED_FRAMES = "dropped_frames"
+CONF_STREAM_DROPPED_FRAMES = "stream_dropped_frames"
+CONF_RX_STACK_FREE = "rx_stack_free"
+CONF_LOOP_STACK_FREE = "loop_stack_free"
+CONF_RX_LATENCY = "rx_latency"
+CONF_TX_LATENCY = "tx_latency"
+CONF_TX_SUCCESS_RATE = "tx_success_rate"
+CONF_TX_COLLISIONS = "tx_collisions"
+CONF_TX_RETRIES = "tx_retries"
+CONF_ARBITRATION_WAIT = "arbitration_wait"
+CONF_TX_WINDOW_ERROR = "tx_window_error"
+CONF_COMMAND_WAIT = "command_wait"
+CONF_BENCHMARK_CYCLES = "benchmark_cycles_per_frame"
+CONF_BENCHMARK_MAX_RATE = "benchmark_max_rate"
+CONF_BENCHMARK_LOOP_JITTER = "benchmark_loop_jitter"
 
 CONFIG_SCHEMA = cv.All(
     cv.COMPONENT_SCHEMA.extend(
@@ -108,10 +144,158 @@ CONFIG_SCHEMA = cv.All(
                 state_class=STATE_CLASS_MEASUREMENT,
                 icon="mdi:timer-outline",
             ),
+            cv.Optional(CONF_PROFILE_APPLY_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=0,
+                device_class=DEVICE_CLASS_DURATION,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:timer-check-outline",
+            ),
+            cv.Optional(CONF_TX_DELAY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:timer-sand",
+            ),
+            cv.Optional(CONF_MODEL_DETECTION_TIME): sensor.sensor_schema(
+                unit_of_measurement=UNIT_SECOND,
+                accuracy_decimals=1,
+                device_class=DEVICE_CLASS_DURATION,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:magnify-scan",
+            ),
+            cv.Optional(CONF_CPU_FREQUENCY): sensor.sensor_schema(
+                unit_of_measurement="MHz",
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:cpu-32-bit",
+            ),
+            cv.Optional(CONF_WAKE_COUNT): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:sleep-off",
+            ),
+            cv.Optional(CONF_DROPPED_FRAMES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:alert-circle-outline",
+            ),
+            cv.Optional(CONF_STREAM_DROPPED_FRAMES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:lan-disconnect",
+            ),
+            cv.Optional(CONF_RX_STACK_FREE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:memory",
+            ),
+            cv.Optional(CONF_LOOP_STACK_FREE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_BYTES,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:memory",
+            ),
+            cv.Optional(CONF_CUSTOM): custom_field_schema(
+                sensor.sensor_schema(SAUNA360CustomSensor)
+            ),
+            cv.Optional(CONF_RX_LATENCY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:timer-outline",
+            ),
+            cv.Optional(CONF_TX_LATENCY): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:timer-outline",
+            ),
+            cv.Optional(CONF_TX_SUCCESS_RATE): sensor.sensor_schema(
+                unit_of_measurement=UNIT_PERCENT,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:check-network-outline",
+            ),
+            cv.Optional(CONF_TX_COLLISIONS): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:call-merge",
+            ),
+            cv.Optional(CONF_TX_RETRIES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_TOTAL_INCREASING,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:replay",
+            ),
+            cv.Optional(CONF_ARBITRATION_WAIT): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:timer-sand",
+            ),
+            # cycle_learner: on the component
+            cv.Optional(CONF_TX_WINDOW_ERROR): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:crosshairs-question",
+            ),
+            cv.Optional(CONF_COMMAND_WAIT): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MILLISECOND,
+                accuracy_decimals=1,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:timer-sand",
+            ),
+            cv.Optional(CONF_BENCHMARK_CYCLES): sensor.sensor_schema(
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:speedometer",
+            ),
+            cv.Optional(CONF_BENCHMARK_MAX_RATE): sensor.sensor_schema(
+                unit_of_measurement="frames/s",
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:speedometer",
+            ),
+            cv.Optional(CONF_BENCHMARK_LOOP_JITTER): sensor.sensor_schema(
+                unit_of_measurement=UNIT_MICROSECOND,
+                accuracy_decimals=0,
+                state_class=STATE_CLASS_MEASUREMENT,
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+                icon="mdi:timer-alert-outline",
+            ),
         }
     ),
 )
 
+FINAL_VALIDATE_SCHEMA = model_feature_validator(
+    {
+        CONF_SETTING_HUMIDITY_STEP: FEATURE_HUMIDITY_STEP,
+        CONF_SETTING_HUMIDITY: FEATURE_HUMIDITY_PERCENT,
+        CONF_WATER_TANK_LEVEL: FEATURE_WATER_TANK,
+        CONF_MODEL_DETECTION_TIME: FEATURE_MODEL_DETECTION,
+    }
+)
+
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
@@ -150,6 +334,70 @@ async def to_code(config):
     if CONF_SESSION_UPTIME in config:
         sens = await sensor.new_sensor(config[CONF_SESSION_UPTIME])
         cg.add(var.set_session_uptime_sensor(sens))
+    if CONF_PROFILE_APPLY_TIME in config:
+        sens = await sensor.new_sensor(config[CONF_PROFILE_APPLY_TIME])
+        cg.add(var.set_profile_apply_time_sensor(sens))
+    if CONF_TX_DELAY in config:
+        sens = await sensor.new_sensor(config[CONF_TX_DELAY])
+        cg.add(var.set_tx_delay_sensor(sens))
+    if CONF_MODEL_DETECTION_TIME in config:
+        sens = await sensor.new_sensor(config[CONF_MODEL_DETECTION_TIME])
+        cg.add(var.set_model_detection_time_sensor(sens))
+    if CONF_CPU_FREQUENCY in config:
+        sens = await sensor.new_sensor(config[CONF_CPU_FREQUENCY])
+        cg.add(var.set_cpu_frequency_sensor(sens))
+    if CONF_WAKE_COUNT in config:
+        sens = await sensor.new_sensor(config[CONF_WAKE_COUNT])
+        cg.add(var.set_wake_count_sensor(sens))
+    if CONF_DROPPED_FRAMES in config:
+        sens = await sensor.new_sensor(config[CONF_DROPPED_FRAMES])
+        cg.add(var.set_dropped_frames_sensor(sens))
+    if CONF_STREAM_DROPPED_FRAMES in config:
+        sens = await sensor.new_sensor(config[CONF_STREAM_DROPPED_FRAMES])
+        cg.add(var.set_stream_dropped_frames_sensor(sens))
+    if CONF_RX_STACK_FREE in config:
+        sens = await sensor.new_sensor(config[CONF_RX_STACK_FREE])
+        cg.add(var.set_rx_stack_free_sensor(sens))
+    if CONF_LOOP_STACK_FREE in config:
+        sens = await sensor.new_sensor(config[CONF_LOOP_STACK_FREE])
+        cg.add(var.set_loop_stack_free_sensor(sens))
+    if CONF_RX_LATENCY in config:
+        sens = await sensor.new_sensor(config[CONF_RX_LATENCY])
+        cg.add(var.set_rx_latency_sensor(sens))
+    if CONF_TX_LATENCY in config:
+        sens = await sensor.new_sensor(config[CONF_TX_LATENCY])
+        cg.add(var.set_tx_latency_sensor(sens))
+    if CONF_TX_SUCCESS_RATE in config:
+        sens = await sensor.new_sensor(config[CONF_TX_SUCCESS_RATE])
+        cg.add(var.set_tx_success_rate_sensor(sens))
+    if CONF_TX_COLLISIONS in config:
+        sens = await sensor.new_sensor(config[CONF_TX_COLLISIONS])
+        cg.add(var.set_tx_collisions_sensor(sens))
+    if CONF_TX_RETRIES in config:
+        sens = await sensor.new_sensor(config[CONF_TX_RETRIES])
+        cg.add(var.set_tx_retries_sensor(sens))
+    if CONF_ARBITRATION_WAIT in config:
+        sens = await sensor.new_sensor(config[CONF_ARBITRATION_WAIT])
+        cg.add(var.set_arbitration_wait_sensor(sens))
+    if CONF_TX_WINDOW_ERROR in config:
+        sens = await sensor.new_sensor(config[CONF_TX_WINDOW_ERROR])
+        cg.add(var.set_tx_window_error_sensor(sens))
+    if CONF_COMMAND_WAIT in config:
+        sens = await sensor.new_sensor(config[CONF_COMMAND_WAIT])
+        cg.add(var.set_command_wait_sensor(sens))
+    if CONF_BENCHMARK_CYCLES in config:
+        sens = await sensor.new_sensor(config[CONF_BENCHMARK_CYCLES])
+        cg.add(var.set_benchmark_cycles_sensor(sens))
+    if CONF_BENCHMARK_MAX_RATE in config:
+        sens = await sensor.new_sensor(config[CONF_BENCHMARK_MAX_RATE])
+        cg.add(var.set_benchmark_max_rate_sensor(sens))
+    if CONF_BENCHMARK_LOOP_JITTER in config:
+        sens = await sensor.new_sensor(config[CONF_BENCHMARK_LOOP_JITTER])
+        cg.add(var.set_benchmark_loop_jitter_sensor(sens))
 
     sauna360 = await cg.get_variable(config[CONF_SAUNA360_ID])
     cg.add(sauna360.register_listener(var))
+
+    for field in config.get(CONF_CUSTOM, []):
+        sens = await sensor.new_sensor(field)
+        await register_custom_field(sauna360, field, sens)
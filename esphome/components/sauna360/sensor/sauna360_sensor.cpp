@@ -20,6 +20,18 @@ void SAUNA360Sensor::dump_config() {
   LOG_SENSOR("  ", "Setting Humidity (%)",        this->setting_humidity_percent_sensor_);
   LOG_SENSOR("  ", "Water Tank Level (%)",        this->water_tank_level_sensor_);
   LOG_SENSOR("  ", "Session Uptime (min)",        this->session_uptime_sensor_);
+  LOG_SENSOR("  ", "Profile Apply Time (ms)",     this->profile_apply_time_sensor_);
+  LOG_SENSOR("  ", "TX Delay (us)",               this->tx_delay_sensor_);
+  LOG_SENSOR("  ", "Model Detection Time (s)",    this->model_detection_time_sensor_);
+  LOG_SENSOR("  ", "CPU Frequency (MHz)",         this->cpu_frequency_sensor_);
+  LOG_SENSOR("  ", "Wake Count",                  this->wake_count_sensor_);
+  LOG_SENSOR("  ", "Dropped Frames",              this->dropped_frames_sensor_);
+  LOG_SENSOR("  ", "RX Stack Free (B)",           this->rx_stack_free_sensor_);
+  LOG_SENSOR("  ", "Loop Stack Free (B)",         this->loop_stack_free_sensor_);
+  LOG_SENSOR("  ", "RX Latency p99 (us)",         this->rx_latency_sensor_);
+  LOG_SENSOR("  ", "TX Latency p99 (us)",         this->tx_latency_sensor_);
+  LOG_SENSOR("  ", "TX Window Error (us)",        this->tx_window_error_sensor_);
+  LOG_SENSOR("  ", "Command Wait (ms)",           this->command_wait_sensor_);
 }
 
 }  // namespace sauna360
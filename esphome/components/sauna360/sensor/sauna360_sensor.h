@@ -122,6 +122,175 @@ public:
     }
   }
 
+  void set_profile_apply_time_sensor(sensor::Sensor *s) {
+    this->profile_apply_time_sensor_ = s;
+  }
+  void on_profile_apply_time(uint32_t ms) override {
+    if (this->profile_apply_time_sensor_ != nullptr)
+      this->profile_apply_time_sensor_->publish_state(static_cast<float>(ms));
+  }
+
+  void set_tx_delay_sensor(sensor::Sensor *s) { this->tx_delay_sensor_ = s; }
+  void on_tx_delay(uint32_t us) override {
+    if (this->tx_delay_sensor_ != nullptr) {
+      const float fv = static_cast<float>(us);
+      if (this->tx_delay_sensor_->get_state() != fv)
+        this->tx_delay_sensor_->publish_state(fv);
+    }
+  }
+
+  void set_model_detection_time_sensor(sensor::Sensor *s) {
+    this->model_detection_time_sensor_ = s;
+  }
+  void on_model_detected(Model, uint32_t detection_ms) override {
+    if (this->model_detection_time_sensor_ != nullptr)
+      this->model_detection_time_sensor_->publish_state(
+          static_cast<float>(detection_ms) / 1000.0f);
+  }
+
+  void set_cpu_frequency_sensor(sensor::Sensor *s) {
+    this->cpu_frequency_sensor_ = s;
+  }
+  void on_cpu_frequency(uint32_t mhz) override {
+    if (this->cpu_frequency_sensor_ != nullptr)
+      this->cpu_frequency_sensor_->publish_state(static_cast<float>(mhz));
+  }
+
+  void set_wake_count_sensor(sensor::Sensor *s) {
+    this->wake_count_sensor_ = s;
+  }
+  void on_wake_count(uint32_t count) override {
+    if (this->wake_count_sensor_ != nullptr)
+      this->wake_count_sensor_->publish_state(static_cast<float>(count));
+  }
+
+  void set_dropped_frames_sensor(sensor::Sensor *s) {
+    this->dropped_frames_sensor_ = s;
+  }
+  void on_dropped_frames(uint32_t count) override {
+    if (this->dropped_frames_sensor_ != nullptr)
+      this->dropped_frames_sensor_->publish_state(static_cast<float>(count));
+  }
+
+  void set_stream_dropped_frames_sensor(sensor::Sensor *s) {
+    this->stream_dropped_frames_sensor_ = s;
+  }
+  void on_stream_dropped(uint32_t count) override {
+    if (this->stream_dropped_frames_sensor_ != nullptr)
+      this->stream_dropped_frames_sensor_->publish_state(
+          static_cast<float>(count));
+  }
+
+  void set_rx_stack_free_sensor(sensor::Sensor *s) {
+    this->rx_stack_free_sensor_ = s;
+  }
+  void on_rx_stack_free(uint32_t bytes) override {
+    if (this->rx_stack_free_sensor_ != nullptr)
+      this->rx_stack_free_sensor_->publish_state(static_cast<float>(bytes));
+  }
+
+  void set_loop_stack_free_sensor(sensor::Sensor *s) {
+    this->loop_stack_free_sensor_ = s;
+  }
+  void on_loop_stack_free(uint32_t bytes) override {
+    if (this->loop_stack_free_sensor_ != nullptr)
+      this->loop_stack_free_sensor_->publish_state(static_cast<float>(bytes));
+  }
+
+  void set_rx_latency_sensor(sensor::Sensor *s) {
+    this->rx_latency_sensor_ = s;
+  }
+  void set_tx_latency_sensor(sensor::Sensor *s) {
+    this->tx_latency_sensor_ = s;
+  }
+  // End-to-end p99 (us); NAN until the stage has samples
+  void on_latency(const LatencyMonitor &latency) override {
+    publish_p99_(this->rx_latency_sensor_,
+                 latency.stage(LatencyMonitor::RX_TOTAL));
+    publish_p99_(this->tx_latency_sensor_,
+                 latency.stage(LatencyMonitor::TX_TOTAL));
+  }
+
+  void set_tx_success_rate_sensor(sensor::Sensor *s) {
+    this->tx_success_rate_sensor_ = s;
+  }
+  void set_tx_collisions_sensor(sensor::Sensor *s) {
+    this->tx_collisions_sensor_ = s;
+  }
+  void set_tx_retries_sensor(sensor::Sensor *s) {
+    this->tx_retries_sensor_ = s;
+  }
+  void set_arbitration_wait_sensor(sensor::Sensor *s) {
+    this->arbitration_wait_sensor_ = s;
+  }
+  void on_arbitration(const TxArbiter &arbiter) override {
+    if (this->tx_success_rate_sensor_ != nullptr)
+      this->tx_success_rate_sensor_->publish_state(arbiter.success_rate());
+    if (this->tx_collisions_sensor_ != nullptr)
+      this->tx_collisions_sensor_->publish_state(
+          static_cast<float>(arbiter.collisions()));
+    if (this->tx_retries_sensor_ != nullptr)
+      this->tx_retries_sensor_->publish_state(
+          static_cast<float>(arbiter.retries()));
+    if (this->arbitration_wait_sensor_ != nullptr)
+      this->arbitration_wait_sensor_->publish_state(
+          static_cast<float>(arbiter.wait_avg_us()));
+  }
+
+  void set_tx_window_error_sensor(sensor::Sensor *s) {
+    this->tx_window_error_sensor_ = s;
+  }
+  void set_command_wait_sensor(sensor::Sensor *s) {
+    this->command_wait_sensor_ = s;
+  }
+  // Averages since boot; nothing until the first prediction / command
+  void on_cycle_learner(const CycleLearner &cycles) override {
+    if (this->tx_window_error_sensor_ != nullptr && cycles.predictions() != 0)
+      this->tx_window_error_sensor_->publish_state(
+          static_cast<float>(cycles.error_avg_us()));
+    if (this->command_wait_sensor_ != nullptr && cycles.wait_avg_us() != 0)
+      this->command_wait_sensor_->publish_state(
+          static_cast<float>(cycles.wait_avg_us()) / 1000.0f);
+  }
+
+  void set_benchmark_cycles_sensor(sensor::Sensor *s) {
+    this->benchmark_cycles_sensor_ = s;
+  }
+  void set_benchmark_max_rate_sensor(sensor::Sensor *s) {
+    this->benchmark_max_rate_sensor_ = s;
+  }
+  void set_benchmark_loop_jitter_sensor(sensor::Sensor *s) {
+    this->benchmark_loop_jitter_sensor_ = s;
+  }
+  void on_benchmark(const Benchmark &bench) override {
+    if (this->benchmark_cycles_sensor_ != nullptr)
+      this->benchmark_cycles_sensor_->publish_state(
+          static_cast<float>(bench.cycles_per_frame()));
+    if (this->benchmark_max_rate_sensor_ != nullptr)
+      this->benchmark_max_rate_sensor_->publish_state(
+          static_cast<float>(bench.max_rate()));
+    if (this->benchmark_loop_jitter_sensor_ != nullptr)
+      this->benchmark_loop_jitter_sensor_->publish_state(
+          static_cast<float>(bench.loop_jitter_us()));
+  }
+
+  // Bus lost: every bus-derived value becomes unknown
+  void on_bus_available(bool available) override {
+    if (available)
+      return;
+    for (sensor::Sensor *s :
+         {this->temperature_sensor_, this->temperature_setting_sensor_,
+          this->remaining_time_sensor_, this->bath_time_setting_sensor_,
+          this->total_uptime_sensor_, this->max_bath_temperature_sensor_,
+          this->overheating_pcb_limit_sensor_,
+          this->setting_humidity_step_sensor_,
+          this->setting_humidity_percent_sensor_,
+          this->water_tank_level_sensor_}) {
+      if (s != nullptr)
+        s->publish_state(NAN);
+    }
+  }
+
 protected:
   sensor::Sensor *temperature_sensor_{nullptr};
   sensor::Sensor *temperature_setting_sensor_{nullptr};
@@ -134,7 +303,45 @@ protected:
   sensor::Sensor *setting_humidity_percent_sensor_{nullptr};
   sensor::Sensor *water_tank_level_sensor_{nullptr};
   sensor::Sensor *session_uptime_sensor_{nullptr};
+  sensor::Sensor *profile_apply_time_sensor_{nullptr};
+  sensor::Sensor *tx_delay_sensor_{nullptr};
+  sensor::Sensor *model_detection_time_sensor_{nullptr};
+  sensor::Sensor *cpu_frequency_sensor_{nullptr};
+  sensor::Sensor *wake_count_sensor_{nullptr};
+  sensor::Sensor *dropped_frames_sensor_{nullptr};
+  sensor::Sensor *stream_dropped_frames_sensor_{nullptr};
+  sensor::Sensor *rx_stack_free_sensor_{nullptr};
+  sensor::Sensor *loop_stack_free_sensor_{nullptr};
+  sensor::Sensor *rx_latency_sensor_{nullptr};
+  sensor::Sensor *tx_latency_sensor_{nullptr};
+  sensor::Sensor *tx_success_rate_sensor_{nullptr};
+  sensor::Sensor *tx_collisions_sensor_{nullptr};
+  sensor::Sensor *tx_retries_sensor_{nullptr};
+  sensor::Sensor *arbitration_wait_sensor_{nullptr};
+  sensor::Sensor *tx_window_error_sensor_{nullptr};
+  sensor::Sensor *command_wait_sensor_{nullptr};
+  sensor::Sensor *benchmark_cycles_sensor_{nullptr};
+  sensor::Sensor *benchmark_max_rate_sensor_{nullptr};
+  sensor::Sensor *benchmark_loop_jitter_sensor_{nullptr};
+
+  static void publish_p99_(sensor::Sensor *s, const LatencyHistogram &h) {
+    if (s == nullptr)
+      return;
+    s->publish_state(h.count() != 0 ? static_cast<float>(h.percentile_us(99))
+                                    : NAN);
+  }
+};
+
+#ifdef SAUNA360_CUSTOM_REGISTERS
+// `custom:` register field
+class SAUNA360CustomSensor : public sensor::Sensor, public CustomFieldSink {
+public:
+  void on_custom_value(uint32_t raw, float value) override {
+    this->publish_state(value);
+  }
+  void on_custom_unavailable() override { this->publish_state(NAN); }
 };
+#endif
 
 } // namespace sauna360
 } // namespace esphome
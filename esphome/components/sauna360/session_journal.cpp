@@ -0,0 +1,186 @@
+#include "session_journal.h"
+
+#ifdef SAUNA360_JOURNAL
+
+#include "esphome/core/log.h"
+
+#include <cstring>
+
+#include "sauna360_protocol.h"
+
+namespace esphome {
+namespace sauna360 {
+
+static const char *const TAG = "sauna360.journal";
+
+const char *SessionJournal::end_reason_name(uint8_t reason) {
+  switch (reason) {
+  case END_HEATER_OFF:
+    return "off";
+  case END_TIME_UP:
+    return "time_up";
+  case END_DOOR:
+    return "door";
+  case END_ERROR:
+    return "error";
+  default:
+    return "unknown";
+  }
+}
+
+bool SessionJournal::blank_(const Record &rec) {
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(&rec);
+  for (size_t i = 0; i < sizeof(rec); i++) {
+    if (p[i] != 0xFF)
+      return false;
+  }
+  return true;
+}
+
+uint16_t SessionJournal::crc_(const Record &rec) {
+  return protocol::crc16(reinterpret_cast<const uint8_t *>(&rec),
+                         offsetof(Record, crc));
+}
+
+bool SessionJournal::read_slot_(uint32_t slot, Record *out) const {
+  if (esp_partition_read(this->part_, slot * sizeof(Record), out,
+                         sizeof(Record)) != ESP_OK)
+    return false;
+  return !blank_(*out) && out->crc == crc_(*out) && !marker_(*out);
+}
+
+bool SessionJournal::setup() {
+  this->part_ = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, this->label_);
+  if (this->part_ == nullptr) {
+    ESP_LOGE(TAG, "Partition '%s' not found", this->label_);
+    return false;
+  }
+  const uint32_t sectors = this->part_->size / SECTOR_SIZE;
+  if (sectors < 2) {
+    ESP_LOGE(TAG, "Partition '%s' needs at least 2 sectors", this->label_);
+    this->part_ = nullptr;
+    return false;
+  }
+  this->slots_ = sectors * PER_SECTOR;
+
+  // Find the newest record; reads go 16 records at a time
+  Record chunk[16];
+  uint32_t newest_seq = 0;
+  uint32_t newest_slot = 0;
+  this->count_ = 0;
+  for (uint32_t base = 0; base < this->slots_; base += 16) {
+    if (esp_partition_read(this->part_, base * sizeof(Record), chunk,
+                           sizeof(chunk)) != ESP_OK)
+      continue;
+    for (uint32_t j = 0; j < 16; j++) {
+      const Record &rec = chunk[j];
+      if (blank_(rec) || rec.crc != crc_(rec))
+        continue;
+      if (!marker_(rec))
+        this->count_++;
+      if (rec.seq >= newest_seq) {
+        newest_seq = rec.seq;
+        newest_slot = base + j;
+      }
+    }
+  }
+  if (newest_seq == 0) {
+    this->next_slot_ = 0;
+    this->next_seq_ = 1;
+  } else {
+    this->next_slot_ = (newest_slot + 1) % this->slots_;
+    this->next_seq_ = newest_seq + 1;
+  }
+  ESP_LOGD(TAG, "%u sessions in '%s', next slot %u", (unsigned)this->count_,
+           this->label_, (unsigned)this->next_slot_);
+  return true;
+}
+
+// True if `slot` can be written. A sector is erased when the write position
+// enters it; used slots in the middle of a sector (torn writes) are skipped.
+bool SessionJournal::prepare_slot_(uint32_t slot) {
+  Record rec;
+  if (esp_partition_read(this->part_, slot * sizeof(Record), &rec,
+                         sizeof(rec)) == ESP_OK &&
+      blank_(rec))
+    return true;
+  if (slot % PER_SECTOR != 0)
+    return false;
+
+  for (uint32_t i = 0; i < PER_SECTOR; i++) {
+    if (this->read_slot_(slot + i, &rec) && this->count_ > 0)
+      this->count_--;
+  }
+  return esp_partition_erase_range(this->part_, slot * sizeof(Record),
+                                   SECTOR_SIZE) == ESP_OK;
+}
+
+bool SessionJournal::append(Record &rec) {
+  if (this->part_ == nullptr)
+    return false;
+  uint32_t tries = 0;
+  while (!this->prepare_slot_(this->next_slot_)) {
+    this->next_slot_ = (this->next_slot_ + 1) % this->slots_;
+    if (++tries >= this->slots_)
+      return false;
+  }
+
+  rec.seq = this->next_seq_;
+  rec.version = VERSION;
+  memset(rec.reserved, 0, sizeof(rec.reserved));
+  rec.crc = crc_(rec);
+  if (esp_partition_write(this->part_, this->next_slot_ * sizeof(Record), &rec,
+                          sizeof(rec)) != ESP_OK) {
+    ESP_LOGW(TAG, "Write failed at slot %u", (unsigned)this->next_slot_);
+    this->next_slot_ = (this->next_slot_ + 1) % this->slots_;
+    return false;
+  }
+  this->next_slot_ = (this->next_slot_ + 1) % this->slots_;
+  this->next_seq_++;
+  this->count_++;
+  return true;
+}
+
+bool SessionJournal::clear() {
+  if (this->part_ == nullptr)
+    return false;
+  if (esp_partition_erase_range(this->part_, 0, this->part_->size) != ESP_OK)
+    return false;
+  this->next_slot_ = 0;
+  this->count_ = 0;
+  if (this->next_seq_ == 1)
+    return true; // nothing was ever numbered
+
+  // Sequence keeps counting so exported data never sees a number twice;
+  // the marker carries it over a reboot
+  Record marker;
+  memset(&marker, 0, sizeof(marker));
+  marker.seq = this->next_seq_ - 1;
+  marker.end_reason = END_MARKER;
+  marker.version = VERSION;
+  marker.crc = crc_(marker);
+  if (esp_partition_write(this->part_, 0, &marker, sizeof(marker)) != ESP_OK) {
+    ESP_LOGW(TAG, "Sequence marker write failed, numbering restarts at 1");
+    this->next_seq_ = 1;
+    return true;
+  }
+  this->next_slot_ = 1;
+  return true;
+}
+
+bool SessionJournal::read(uint32_t i, Record *out) const {
+  if (this->part_ == nullptr || i >= this->slots_)
+    return false;
+  // Oldest records: the sector the write position is about to erase, or
+  // the one after it when it is part-way through a sector
+  uint32_t oldest = this->next_slot_;
+  if (oldest % PER_SECTOR != 0)
+    oldest = ((oldest / PER_SECTOR + 1) * PER_SECTOR) % this->slots_;
+  return this->read_slot_((oldest + i) % this->slots_, out);
+}
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // SAUNA360_JOURNAL
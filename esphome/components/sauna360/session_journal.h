@@ -0,0 +1,96 @@
+#pragma once
+
+#include "esphome/core/defines.h"
+
+#ifdef SAUNA360_JOURNAL
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_partition.h"
+
+namespace esphome {
+namespace sauna360 {
+
+// Append-only session log in its own data partition (journal: in YAML).
+//
+// The partition is a ring of 4 KiB sectors holding fixed 32-byte records,
+// each with a sequence number and CRC. Records are appended to the first
+// blank slot after the newest one; when a sector is full the next (oldest)
+// sector is erased, so every sector is erased once per trip around the
+// ring. A record torn by a power loss fails its CRC and is skipped.
+// clear() leaves a marker record holding the last sequence number, so the
+// numbering carries on across the erase and a reboot; markers are not
+// sessions and read() skips them.
+//
+// Flash writes stall both cores: main loop only, never the RX task.
+class SessionJournal {
+public:
+  enum EndReason : uint8_t {
+    END_UNKNOWN = 0,
+    END_HEATER_OFF = 1, // switched off (panel, HA, timer in the heater)
+    END_TIME_UP = 2,    // remaining time reached zero
+    END_DOOR = 3,       // door open too long
+    END_ERROR = 4,      // sensor / limit error reported by the heater
+    END_MARKER = 0xFF,  // not a session: sequence marker left by clear()
+  };
+  static const char *end_reason_name(uint8_t reason);
+
+  struct Record {
+    uint32_t seq;        // 0xFFFFFFFF = blank slot
+    uint32_t start_time; // UNIX time, 0 if the clock was not set
+    uint32_t duration_s;
+    uint32_t coil_on_s;
+    int16_t peak_temp_x10; // C * 10
+    int16_t avg_temp_x10;
+    uint8_t setpoint_start; // C
+    uint8_t setpoint_end;
+    uint8_t door_events;
+    uint8_t end_reason; // EndReason
+    uint8_t version;
+    uint8_t reserved[5];
+    uint16_t crc; // protocol::crc16 over the preceding 30 bytes
+  };
+  static_assert(sizeof(Record) == 32, "journal record must be 32 bytes");
+
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint32_t SECTOR_SIZE = 4096;
+  static constexpr uint32_t PER_SECTOR = SECTOR_SIZE / sizeof(Record);
+
+  void set_partition_label(const char *label) { this->label_ = label; }
+  const char *partition_label() const { return this->label_; }
+
+  // Finds the partition and the write position. False if unusable.
+  bool setup();
+  bool ready() const { return this->part_ != nullptr; }
+
+  // Assigns seq and CRC, then writes the record
+  bool append(Record &rec);
+  bool clear();
+
+  uint32_t slots() const { return this->slots_; }
+  uint32_t count() const { return this->count_; }
+  // Slot `i` counted from the oldest sector. False for blank / corrupt.
+  bool read(uint32_t i, Record *out) const;
+
+protected:
+  static bool blank_(const Record &rec);
+  static bool marker_(const Record &rec) {
+    return rec.end_reason == END_MARKER;
+  }
+  static uint16_t crc_(const Record &rec);
+  bool read_slot_(uint32_t slot, Record *out) const;
+  bool prepare_slot_(uint32_t slot);
+
+  const char *label_{"sauna_journal"};
+  const esp_partition_t *part_{nullptr};
+  uint32_t slots_{0};
+  uint32_t next_slot_{0}; // where the next record goes
+  uint32_t next_seq_{1};
+  uint32_t count_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
+
+#endif // SAUNA360_JOURNAL
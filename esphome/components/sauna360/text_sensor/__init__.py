@@ -1,16 +1,38 @@
 import esphome.codegen as cg
 from esphome.components import text_sensor
 import esphome.config_validation as cv
-from esphome.const import CONF_ID
+from esphome.const import CONF_ID, ENTITY_CATEGORY_DIAGNOSTIC
 
-from .. import sauna360_ns, SAUNA360Component, CONF_SAUNA360_ID
+from .. import (
+    sauna360_ns,
+    SAUNA360Component,
+    CONF_SAUNA360_ID,
+    CONF_CUSTOM,
+    custom_field_schema,
+    register_custom_field,
+    FEATURE_MODEL_DETECTION,
+    model_feature_validator,
+)
 
 SAUNA360TextSensor = sauna360_ns.class_(
     "SAUNA360TextSensor", text_sensor.TextSensor, cg.Component
 )
+SAUNA360CustomTextSensor = sauna360_ns.class_(
+    "SAUNA360CustomTextSensor", text_sensor.TextSensor
+)
+SAUNA360SnapshotTextSensor = sauna360_ns.class_(
+    "SAUNA360SnapshotTextSensor", text_sensor.TextSensor, cg.Component
+)
 
 CONF_HEATER_STATE = "heater_state"
 CONF_HEAT_WAVES = "heat_waves"
+CONF_IFG_HISTOGRAM = "ifg_histogram"
+CONF_LATENCY = "latency"
+CONF_ANOMALY = "anomaly"
+CONF_DETECTED_MODEL = "detected_model"
+CONF_MAP = "map"
+CONF_STATE_SNAPSHOT = "state_snapshot"
+CONF_MIN_INTERVAL = "min_interval"
 
 CONFIG_SCHEMA = cv.All(
     cv.COMPONENT_SCHEMA.extend(
@@ -23,10 +45,55 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(CONF_HEAT_WAVES): text_sensor.text_sensor_schema(
                 icon="mdi:heat-wave",
             ),
+            cv.Optional(CONF_IFG_HISTOGRAM): text_sensor.text_sensor_schema(
+                icon="mdi:chart-histogram",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_LATENCY): text_sensor.text_sensor_schema(
+                icon="mdi:timer-outline",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_ANOMALY): text_sensor.text_sensor_schema(
+                icon="mdi:alert-decagram-outline",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            cv.Optional(CONF_DETECTED_MODEL): text_sensor.text_sensor_schema(
+                icon="mdi:magnify-scan",
+                entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+            ),
+            # All decoded fields in one packed entity (README)
+            cv.Optional(CONF_STATE_SNAPSHOT): text_sensor.text_sensor_schema(
+                SAUNA360SnapshotTextSensor,
+                icon="mdi:package-variant-closed",
+            )
+            .extend(
+                {
+                    cv.Optional(CONF_MIN_INTERVAL, default="1s"): cv.All(
+                        cv.positive_time_period_milliseconds,
+                        cv.Range(max=cv.TimePeriod(minutes=10)),
+                    ),
+                }
+            )
+            .extend(cv.COMPONENT_SCHEMA),
+            # Raw field value -> text; unmapped values are shown in hex
+            cv.Optional(CONF_CUSTOM): custom_field_schema(
+                text_sensor.text_sensor_schema(SAUNA360CustomTextSensor).extend(
+                    {
+                        cv.Optional(CONF_MAP, default={}): cv.Schema(
+                            {cv.uint32_t: cv.string}
+                        ),
+                    }
+                ),
+                scaled=False,
+            ),
         }
     ),
 )
 
+FINAL_VALIDATE_SCHEMA = model_feature_validator(
+    {CONF_DETECTED_MODEL: FEATURE_MODEL_DETECTION}
+)
+
 
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
@@ -40,5 +107,33 @@ async def to_code(config):
         waves = await text_sensor.new_text_sensor(config[CONF_HEAT_WAVES])
         cg.add(var.set_heat_waves_text_sensor(waves))
 
+    if CONF_IFG_HISTOGRAM in config:
+        hist = await text_sensor.new_text_sensor(config[CONF_IFG_HISTOGRAM])
+        cg.add(var.set_ifg_histogram_text_sensor(hist))
+
+    if CONF_LATENCY in config:
+        latency = await text_sensor.new_text_sensor(config[CONF_LATENCY])
+        cg.add(var.set_latency_text_sensor(latency))
+
+    if CONF_ANOMALY in config:
+        anomaly = await text_sensor.new_text_sensor(config[CONF_ANOMALY])
+        cg.add(var.set_anomaly_text_sensor(anomaly))
+
+    if CONF_DETECTED_MODEL in config:
+        detected = await text_sensor.new_text_sensor(config[CONF_DETECTED_MODEL])
+        cg.add(var.set_detected_model_text_sensor(detected))
+
     sauna360 = await cg.get_variable(config[CONF_SAUNA360_ID])
     cg.add(sauna360.register_listener(var))
+
+    if snapshot_config := config.get(CONF_STATE_SNAPSHOT):
+        snapshot = await text_sensor.new_text_sensor(snapshot_config)
+        await cg.register_component(snapshot, snapshot_config)
+        cg.add(snapshot.set_min_interval(snapshot_config[CONF_MIN_INTERVAL]))
+        cg.add(sauna360.register_listener(snapshot))
+
+    for field in config.get(CONF_CUSTOM, []):
+        sens = await text_sensor.new_text_sensor(field)
+        for raw, text in field[CONF_MAP].items():
+            cg.add(sens.add_mapping(raw, text))
+        await register_custom_field(sauna360, field, sens)
@@ -1,6 +1,9 @@
 #include "sauna360_text_sensor.h"
 #include "esphome/core/log.h"
 
+#include <cstdio>
+#include <cstring>
+
 namespace esphome {
 namespace sauna360 {
 
@@ -16,7 +19,45 @@ void SAUNA360TextSensor::set_heat_waves_text_sensor(
   this->heat_waves_text_sensor_ = tsensor;
 }
 
-void SAUNA360TextSensor::on_heater_state(const std::string &state) {
+void SAUNA360TextSensor::set_ifg_histogram_text_sensor(
+    text_sensor::TextSensor *tsensor) {
+  this->ifg_histogram_text_sensor_ = tsensor;
+  reserve_(tsensor, &this->ifg_histogram_str_);
+}
+
+void SAUNA360TextSensor::set_latency_text_sensor(
+    text_sensor::TextSensor *tsensor) {
+  this->latency_text_sensor_ = tsensor;
+  reserve_(tsensor, &this->latency_str_);
+}
+
+void SAUNA360TextSensor::set_anomaly_text_sensor(
+    text_sensor::TextSensor *tsensor) {
+  this->anomaly_text_sensor_ = tsensor;
+}
+
+void SAUNA360TextSensor::set_detected_model_text_sensor(
+    text_sensor::TextSensor *tsensor) {
+  this->detected_model_text_sensor_ = tsensor;
+}
+
+void SAUNA360TextSensor::reserve_(text_sensor::TextSensor *tsensor,
+                                  std::string *scratch) {
+  scratch->reserve(DIAG_TEXT_MAX);
+  tsensor->state.reserve(DIAG_TEXT_MAX);
+  tsensor->raw_state.reserve(DIAG_TEXT_MAX);
+}
+
+void SAUNA360TextSensor::publish_reserved_(text_sensor::TextSensor *tsensor,
+                                           std::string *scratch,
+                                           const char *text) {
+  if (tsensor->state == text)
+    return;
+  scratch->assign(text, strnlen(text, DIAG_TEXT_MAX));
+  tsensor->publish_state(*scratch);
+}
+
+void SAUNA360TextSensor::on_heater_state(const char *state) {
   if (this->heater_state_text_sensor_ != nullptr) {
     this->heater_state_text_sensor_->publish_state(state);
   }
@@ -41,10 +82,211 @@ void SAUNA360TextSensor::on_coils_active(uint8_t cnt) {
   this->heat_waves_text_sensor_->publish_state(s);
 }
 
+void SAUNA360TextSensor::on_ifg_histogram(const char *hist) {
+  if (this->ifg_histogram_text_sensor_ != nullptr)
+    publish_reserved_(this->ifg_histogram_text_sensor_,
+                      &this->ifg_histogram_str_, hist);
+}
+
+void SAUNA360TextSensor::on_bus_available(bool available) {
+  if (available)
+    return;
+  this->on_heater_state("Bus unavailable");
+}
+
+// p50/p99/max in microseconds per pipeline stage
+void SAUNA360TextSensor::on_latency(const LatencyMonitor &latency) {
+  if (this->latency_text_sensor_ == nullptr)
+    return;
+  char buf[DIAG_TEXT_MAX];
+  latency.format(buf, sizeof(buf));
+  publish_reserved_(this->latency_text_sensor_, &this->latency_str_, buf);
+}
+
+// "<reason>: <detail>", e.g. "coil_cycling: switched on every 20 s (min 60 s)"
+void SAUNA360TextSensor::on_anomaly(AnomalyDetector::Reason reason,
+                                    const char *detail) {
+  if (this->anomaly_text_sensor_ == nullptr)
+    return;
+  char buf[AnomalyDetector::DETAIL_MAX + 24];
+  snprintf(buf, sizeof(buf), "%s: %s", AnomalyDetector::reason_name(reason),
+           detail);
+  this->anomaly_text_sensor_->publish_state(buf);
+}
+
+void SAUNA360TextSensor::on_model_detected(Model model, uint32_t) {
+  if (this->detected_model_text_sensor_ != nullptr)
+    this->detected_model_text_sensor_->publish_state(model_name(model));
+}
+
+template <typename T>
+void SAUNA360SnapshotTextSensor::set_(T Fields::*field, T value) {
+  LockGuard guard(this->lock_);
+  if (this->fields_.*field == value)
+    return;
+  this->fields_.*field = value;
+  this->dirty_ = true;
+  this->changes_++;
+}
+
+// Read-modify-write of the shared byte, so all of it under the lock
+void SAUNA360SnapshotTextSensor::set_flag_(uint8_t flag, bool on) {
+  LockGuard guard(this->lock_);
+  const uint8_t flags = on ? (this->fields_.flags | flag)
+                           : (this->fields_.flags & ~flag);
+  if (this->fields_.flags == flags)
+    return;
+  this->fields_.flags = flags;
+  this->dirty_ = true;
+  this->changes_++;
+}
+
+void SAUNA360SnapshotTextSensor::on_temperature(uint16_t v) {
+  this->set_(&Fields::temperature, static_cast<uint8_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_temperature_setting(uint16_t v) {
+  this->set_(&Fields::temperature_setting, static_cast<uint8_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_remaining_time(uint16_t v) {
+  this->set_(&Fields::remaining_time, v);
+}
+void SAUNA360SnapshotTextSensor::on_bath_time_setting(uint16_t v) {
+  this->set_(&Fields::bath_time, v);
+}
+void SAUNA360SnapshotTextSensor::on_total_uptime(uint32_t v) {
+  this->set_(&Fields::total_uptime, v);
+}
+void SAUNA360SnapshotTextSensor::on_max_bath_temperature(uint16_t v) {
+  this->set_(&Fields::max_bath_temperature, static_cast<uint8_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_overheating_pcb_limit(uint16_t v) {
+  this->set_(&Fields::overheating_pcb_limit, static_cast<uint8_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_heater_status(bool on) {
+  this->set_flag_(FLAG_HEATER, on);
+}
+// States are string literals, compared by pointer as in the component
+void SAUNA360SnapshotTextSensor::on_heater_state(const char *state) {
+  this->set_(&Fields::state, state);
+}
+void SAUNA360SnapshotTextSensor::on_light_status(bool on) {
+  this->set_flag_(FLAG_LIGHT, on);
+}
+void SAUNA360SnapshotTextSensor::on_ready_status(bool ready) {
+  this->set_flag_(FLAG_READY, ready);
+}
+void SAUNA360SnapshotTextSensor::on_bus_available(bool available) {
+  this->set_flag_(FLAG_BUS, available);
+}
+void SAUNA360SnapshotTextSensor::on_setting_humidity_step(uint16_t v) {
+  this->set_(&Fields::humidity_step, static_cast<uint8_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_setting_humidity_percent(uint16_t v) {
+  this->set_(&Fields::humidity_percent, static_cast<uint8_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_water_tank_level(uint16_t v) {
+  this->set_(&Fields::water_tank_level, static_cast<uint8_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_session_uptime(uint32_t v) {
+  this->set_(&Fields::session_uptime, static_cast<uint16_t>(v));
+}
+void SAUNA360SnapshotTextSensor::on_coils_active(uint8_t v) {
+  this->set_(&Fields::coils_active, v);
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v) {
+  *p++ = v & 0xFF;
+  *p++ = v >> 8;
+  return p;
+}
+
+size_t SAUNA360SnapshotTextSensor::encode_(const Fields &f,
+                                           uint8_t *out) const {
+  uint8_t *p = out;
+  *p++ = VERSION;
+  p = put_u16(p, this->seq_);
+  *p++ = f.temperature;
+  *p++ = f.temperature_setting;
+  p = put_u16(p, f.remaining_time);
+  p = put_u16(p, f.bath_time);
+  *p++ = f.max_bath_temperature;
+  *p++ = f.overheating_pcb_limit;
+  *p++ = f.humidity_step;
+  *p++ = f.humidity_percent;
+  *p++ = f.water_tank_level;
+  *p++ = f.coils_active;
+  *p++ = f.flags;
+  p = put_u16(p, f.session_uptime);
+  p = put_u16(p, f.total_uptime & 0xFFFF);
+  p = put_u16(p, f.total_uptime >> 16);
+  const size_t state_len = strnlen(f.state, STATE_MAX);
+  *p++ = static_cast<uint8_t>(state_len);
+  memcpy(p, f.state, state_len);
+  return (p - out) + state_len;
+}
+
+void SAUNA360SnapshotTextSensor::loop() {
+  const uint32_t now = millis();
+  if (this->dirty_ &&
+      (this->seq_ == 0 ||
+       (now - this->last_publish_ms_) >= this->min_interval_ms_)) {
+    Fields f;
+    {
+      LockGuard guard(this->lock_);
+      f = this->fields_;
+      this->dirty_ = false;
+    }
+    this->seq_++;
+    uint8_t buf[23 + STATE_MAX];
+    const size_t len = this->encode_(f, buf);
+    this->publish_state(base64_encode(buf, len));
+    this->last_publish_ms_ = now;
+    this->messages_++;
+    this->bytes_ += this->state.size();
+  }
+
+  if ((now - this->stats_ms_) >= STATS_INTERVAL_MS) {
+    if (this->stats_ms_ != 0)
+      ESP_LOGD(TAG,
+               "Snapshot: %u messages, %u bytes for %u field changes in "
+               "the last minute",
+               (unsigned)this->messages_, (unsigned)this->bytes_,
+               (unsigned)this->changes_);
+    this->messages_ = 0;
+    this->bytes_ = 0;
+    this->changes_ = 0;
+    this->stats_ms_ = now;
+  }
+}
+
+void SAUNA360SnapshotTextSensor::dump_config() {
+  LOG_TEXT_SENSOR("", "SAUNA360 State Snapshot", this);
+  ESP_LOGCONFIG(TAG, "  Min interval: %u ms",
+                (unsigned)this->min_interval_ms_);
+}
+
+#ifdef SAUNA360_CUSTOM_REGISTERS
+void SAUNA360CustomTextSensor::on_custom_value(uint32_t raw, float value) {
+  for (const auto &m : this->mapping_) {
+    if (m.first == raw) {
+      this->publish_state(m.second);
+      return;
+    }
+  }
+  char buf[12];
+  snprintf(buf, sizeof(buf), "0x%X", (unsigned)raw);
+  this->publish_state(buf);
+}
+#endif
+
 void SAUNA360TextSensor::dump_config() {
   ESP_LOGCONFIG(TAG, "SAUNA360 TextSensor:");
   LOG_TEXT_SENSOR("  ", "Heater State", this->heater_state_text_sensor_);
   LOG_TEXT_SENSOR("  ", "Heat Waves", this->heat_waves_text_sensor_);
+  LOG_TEXT_SENSOR("  ", "IFG Histogram", this->ifg_histogram_text_sensor_);
+  LOG_TEXT_SENSOR("  ", "Latency", this->latency_text_sensor_);
+  LOG_TEXT_SENSOR("  ", "Anomaly", this->anomaly_text_sensor_);
+  LOG_TEXT_SENSOR("  ", "Detected Model", this->detected_model_text_sensor_);
 }
 
 } // namespace sauna360
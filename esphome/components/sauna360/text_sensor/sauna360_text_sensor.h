@@ -12,14 +12,144 @@ class SAUNA360TextSensor : public Component,
 public:
   void set_heater_state_text_sensor(text_sensor::TextSensor *tsensor);
   void set_heat_waves_text_sensor(text_sensor::TextSensor *tsensor);
-  void on_heater_state(const std::string &state) override;
+  void set_ifg_histogram_text_sensor(text_sensor::TextSensor *tsensor);
+  void set_latency_text_sensor(text_sensor::TextSensor *tsensor);
+  void set_anomaly_text_sensor(text_sensor::TextSensor *tsensor);
+  void set_detected_model_text_sensor(text_sensor::TextSensor *tsensor);
+  void on_heater_state(const char *state) override;
   void on_coils_active(uint8_t cnt) override;
+  void on_ifg_histogram(const char *hist) override;
+  void on_bus_available(bool available) override;
+  void on_latency(const LatencyMonitor &latency) override;
+  void on_anomaly(AnomalyDetector::Reason reason, const char *detail) override;
+  void on_model_detected(Model model, uint32_t detection_ms) override;
   void dump_config() override;
 
 protected:
   text_sensor::TextSensor *heater_state_text_sensor_{nullptr};
   text_sensor::TextSensor *heat_waves_text_sensor_{nullptr};
+  text_sensor::TextSensor *ifg_histogram_text_sensor_{nullptr};
+  text_sensor::TextSensor *latency_text_sensor_{nullptr};
+  text_sensor::TextSensor *anomaly_text_sensor_{nullptr};
+  text_sensor::TextSensor *detected_model_text_sensor_{nullptr};
+
+  // Diagnostics published from SAUNA360Component::loop(). The text goes
+  // through a scratch string, and it and the entity's state strings are
+  // reserved up front, so a publish only copies into existing capacity
+  // (heap_audit).
+  static constexpr size_t DIAG_TEXT_MAX = 256;
+  static void reserve_(text_sensor::TextSensor *tsensor, std::string *scratch);
+  static void publish_reserved_(text_sensor::TextSensor *tsensor,
+                                std::string *scratch, const char *text);
+  std::string ifg_histogram_str_;
+  std::string latency_str_;
+};
+
+// The whole decoded state in one entity (state_snapshot), for clients that
+// would otherwise subscribe to every sensor. Each publish is base64 of:
+//   u8  version (1)
+//   u16 seq              increments per publish
+//   u8  temperature      C
+//   u8  temperature_setting C
+//   u16 remaining_time   min
+//   u16 bath_time        min
+//   u8  max_bath_temperature C
+//   u8  overheating_pcb_limit C
+//   u8  humidity_step, humidity_percent, water_tank_level (%)
+//   u8  coils_active
+//   u8  flags            FLAG_*
+//   u16 session_uptime   min
+//   u32 total_uptime     as reported by the heater
+//   u8  state_len, then the heater state text
+// all little-endian. Fields are updated from the listener callbacks (RX
+// task and main loop); loop() publishes when something changed, at most
+// once per min_interval.
+class SAUNA360SnapshotTextSensor : public text_sensor::TextSensor,
+                                   public SAUNA360Listener,
+                                   public Component {
+public:
+  static constexpr uint8_t VERSION = 1;
+  static constexpr uint8_t FLAG_HEATER = 1 << 0;
+  static constexpr uint8_t FLAG_LIGHT = 1 << 1;
+  static constexpr uint8_t FLAG_READY = 1 << 2;
+  static constexpr uint8_t FLAG_BUS = 1 << 3;
+  static constexpr uint8_t STATE_MAX = 48;
+  static constexpr uint32_t STATS_INTERVAL_MS = 60000;
+
+  void set_min_interval(uint32_t ms) { this->min_interval_ms_ = ms; }
+
+  void on_temperature(uint16_t v) override;
+  void on_temperature_setting(uint16_t v) override;
+  void on_remaining_time(uint16_t v) override;
+  void on_bath_time_setting(uint16_t v) override;
+  void on_total_uptime(uint32_t v) override;
+  void on_max_bath_temperature(uint16_t v) override;
+  void on_overheating_pcb_limit(uint16_t v) override;
+  void on_heater_status(bool on) override;
+  void on_heater_state(const char *state) override;
+  void on_light_status(bool on) override;
+  void on_ready_status(bool ready) override;
+  void on_bus_available(bool available) override;
+  void on_setting_humidity_step(uint16_t v) override;
+  void on_setting_humidity_percent(uint16_t v) override;
+  void on_water_tank_level(uint16_t v) override;
+  void on_session_uptime(uint32_t v) override;
+  void on_coils_active(uint8_t v) override;
+
+  void loop() override;
+  void dump_config() override;
+
+protected:
+  struct Fields {
+    uint8_t temperature{0};
+    uint8_t temperature_setting{0};
+    uint16_t remaining_time{0};
+    uint16_t bath_time{0};
+    uint8_t max_bath_temperature{0};
+    uint8_t overheating_pcb_limit{0};
+    uint8_t humidity_step{0};
+    uint8_t humidity_percent{0};
+    uint8_t water_tank_level{0};
+    uint8_t coils_active{0};
+    uint8_t flags{0};
+    uint16_t session_uptime{0};
+    uint32_t total_uptime{0};
+    const char *state{""}; // string literal from the component
+  };
+
+  template <typename T> void set_(T Fields::*field, T value);
+  void set_flag_(uint8_t flag, bool on);
+  size_t encode_(const Fields &f, uint8_t *out) const;
+
+  Mutex lock_;
+  Fields fields_;
+  bool dirty_{false};
+  uint32_t min_interval_ms_{1000};
+  uint32_t last_publish_ms_{0};
+  uint16_t seq_{0};
+  // Per minute: field changes (one state message each as separate
+  // entities) against what the snapshot sent
+  uint32_t changes_{0};
+  uint32_t messages_{0};
+  uint32_t bytes_{0};
+  uint32_t stats_ms_{0};
+};
+
+#ifdef SAUNA360_CUSTOM_REGISTERS
+// `custom:` register field, mapped to text
+class SAUNA360CustomTextSensor : public text_sensor::TextSensor,
+                                 public CustomFieldSink {
+public:
+  void add_mapping(uint32_t raw, const std::string &text) {
+    this->mapping_.emplace_back(raw, text);
+  }
+  void on_custom_value(uint32_t raw, float value) override;
+  void on_custom_unavailable() override { this->publish_state(""); }
+
+protected:
+  std::vector<std::pair<uint32_t, std::string>> mapping_;
 };
+#endif
 
 } // namespace sauna360
 } // namespace esphome
@@ -0,0 +1,148 @@
+#include "tx_arbiter.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace sauna360 {
+
+void TxArbiter::set_node(uint8_t node_id, uint32_t slot_spacing_us) {
+  this->node_id_ = node_id;
+  this->slot_spacing_us_ = slot_spacing_us;
+  // Different sequence per node so two nodes do not back off in lockstep
+  this->rng_ = 0x9E3779B9u * (node_id + 1u);
+}
+
+uint32_t TxArbiter::random_() {
+  // xorshift32
+  uint32_t x = this->rng_;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  this->rng_ = x;
+  return x;
+}
+
+bool TxArbiter::may_transmit(uint32_t now_us) {
+  if (!this->waiting_) {
+    this->waiting_ = true;
+    this->wait_start_us_ = now_us;
+  }
+  if (this->backoff_cycles_ == 0)
+    return true;
+  this->backoff_cycles_--;
+  return false;
+}
+
+void TxArbiter::on_deferred() {
+  this->deferred_ = this->deferred_ + 1;
+}
+
+void TxArbiter::start_backoff_() {
+  if (this->backoff_exp_ < MAX_BACKOFF_EXP)
+    this->backoff_exp_++;
+  this->backoff_cycles_ =
+      1 + (this->random_() & ((1u << this->backoff_exp_) - 1));
+}
+
+void TxArbiter::on_sent(const uint8_t *frame, size_t len, uint32_t now_us) {
+  this->attempts_ = this->attempts_ + 1;
+  if (this->waiting_) {
+    this->waiting_ = false;
+    const uint32_t wait = now_us - this->wait_start_us_;
+    this->wait_sum_us_ += wait;
+    this->waits_++;
+    if (wait > this->wait_max_us_)
+      this->wait_max_us_ = wait;
+  }
+
+  if (static_cast<uint8_t>(this->pending_tail_ - this->pending_head_) >=
+          MAX_PENDING ||
+      len > protocol::MAX_FRAME_LEN) {
+    this->unconfirmed_ = this->unconfirmed_ + 1;
+    return;
+  }
+  // Frames of one batch are written back-to-back: each deadline is counted
+  // from the end of the previous one
+  uint32_t start = now_us;
+  if (this->pending_tail_ != this->pending_head_) {
+    const Pending &prev =
+        this->pending_[(this->pending_tail_ - 1) & (MAX_PENDING - 1)];
+    start = prev.deadline_us - ECHO_SLACK_US;
+  }
+  Pending &p = this->pending_[this->pending_tail_ & (MAX_PENDING - 1)];
+  p.len = static_cast<uint8_t>(len);
+  p.deadline_us = start + len * CHAR_TIME_US + ECHO_SLACK_US;
+  memcpy(p.data, frame, len);
+  this->pending_tail_++;
+}
+
+bool TxArbiter::on_collision(uint8_t attempt) {
+  // Counted like an echo mismatch; the garbled echo that follows finds
+  // nothing pending and is ignored
+  this->attempts_ = this->attempts_ + 1;
+  this->collisions_ = this->collisions_ + 1;
+  this->start_backoff_();
+  if (attempt > this->max_retries_) {
+    this->abandoned_ = this->abandoned_ + 1;
+    return false;
+  }
+  this->retries_ = this->retries_ + 1;
+  return true;
+}
+
+void TxArbiter::expire_(uint32_t now_us) {
+  while (this->pending_head_ != this->pending_tail_) {
+    const Pending &p = this->pending_[this->pending_head_ & (MAX_PENDING - 1)];
+    if (static_cast<int32_t>(now_us - p.deadline_us) < 0)
+      break;
+    // No echo in time: either the transceiver does not echo, or the frame
+    // was lost entirely
+    if (this->echo_seen_) {
+      this->collisions_ = this->collisions_ + 1;
+      this->start_backoff_();
+    } else {
+      this->unconfirmed_ = this->unconfirmed_ + 1;
+    }
+    this->pending_head_++;
+  }
+}
+
+void TxArbiter::on_frame(const uint8_t *frame, size_t len, bool valid,
+                         uint32_t now_us) {
+  this->expire_(now_us);
+  if (this->pending_head_ == this->pending_tail_)
+    return;
+
+  const Pending &p = this->pending_[this->pending_head_ & (MAX_PENDING - 1)];
+  if (valid && len == p.len && memcmp(frame, p.data, len) == 0) {
+    this->echo_seen_ = true;
+    this->confirmed_ = this->confirmed_ + 1;
+    this->backoff_exp_ = 0;
+    this->pending_head_++;
+    return;
+  }
+  if (!this->echo_seen_) {
+    // Probably a transceiver without echo: this is the next talker's frame
+    this->unconfirmed_ =
+        this->unconfirmed_ +
+        static_cast<uint8_t>(this->pending_tail_ - this->pending_head_);
+    this->clear_pending_();
+    return;
+  }
+  // Garbled or foreign frame where our echo should be
+  this->collisions_ = this->collisions_ + 1;
+  this->clear_pending_();
+  this->start_backoff_();
+}
+
+float TxArbiter::success_rate() const {
+  const uint32_t attempts = this->attempts_;
+  if (attempts == 0)
+    return 100.0f;
+  const uint32_t collisions = this->collisions_;
+  const uint32_t ok = attempts > collisions ? attempts - collisions : 0;
+  return 100.0f * static_cast<float>(ok) / static_cast<float>(attempts);
+}
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "sauna360_protocol.h"
+
+namespace esphome {
+namespace sauna360 {
+
+// Shares the post-EOF TX slot between several nodes on one bus and checks
+// our own echo to confirm each frame went out intact.
+//
+// Arbitration: node N waits an extra N * slot_spacing before it transmits
+// and gives way if anything is on the wire by then (carrier sense), so the
+// lowest node ID wins a contended slot. After a collision the node backs
+// off a random 1..2^k panel cycles (binary exponential, k <= MAX_BACKOFF_EXP).
+//
+// Echo: every frame we write is expected back byte-for-byte within its
+// air time. A different frame or a CRC error in that window is a collision.
+// Transceivers that do not echo are detected (no echo ever seen) and their
+// frames are counted as unconfirmed instead.
+//
+// With rs485: the UART compares the echo itself while the frame goes out
+// (on_collision). The frame is then retried after the backoff instead of
+// being lost, up to max_retries times. RX task only, except the read-only
+// accessors.
+class TxArbiter {
+public:
+  static constexpr uint32_t CHAR_TIME_US = 573; // 19200 8E1
+  static constexpr uint32_t ECHO_SLACK_US = 5000;
+  static constexpr uint8_t MAX_PENDING = 8;
+  static constexpr uint8_t MAX_BACKOFF_EXP = 4;
+
+  void set_node(uint8_t node_id, uint32_t slot_spacing_us);
+  void set_max_retries(uint8_t retries) { this->max_retries_ = retries; }
+  uint8_t max_retries() const { return this->max_retries_; }
+  uint8_t node_id() const { return this->node_id_; }
+  uint32_t slot_offset_us() const {
+    return static_cast<uint32_t>(this->node_id_) * this->slot_spacing_us_;
+  }
+
+  // Called for each panel EOF with a frame waiting. False while backing off.
+  bool may_transmit(uint32_t now_us);
+  // Slot lost to another talker (bus busy after our offset)
+  void on_deferred();
+  // Frame handed to the UART
+  void on_sent(const uint8_t *frame, size_t len, uint32_t now_us);
+  // Every frame received (raw, escaped, SOF..EOF)
+  void on_frame(const uint8_t *frame, size_t len, bool valid,
+                uint32_t now_us);
+  // UART reported a collision on a frame's `attempt`th try (1-based). True
+  // if it should be sent again, false once it is to be dropped.
+  bool on_collision(uint8_t attempt);
+
+  uint32_t attempts() const { return this->attempts_; }
+  uint32_t confirmed() const { return this->confirmed_; }
+  uint32_t collisions() const { return this->collisions_; }
+  uint32_t unconfirmed() const { return this->unconfirmed_; }
+  uint32_t deferred() const { return this->deferred_; }
+  uint32_t retries() const { return this->retries_; }
+  uint32_t abandoned() const { return this->abandoned_; }
+  bool echo_seen() const { return this->echo_seen_; }
+  // Percentage of frames that went out intact, 100 before the first frame
+  float success_rate() const;
+  // Time from the first contended slot to the actual transmission
+  uint32_t wait_avg_us() const {
+    return this->waits_ != 0 ? static_cast<uint32_t>(this->wait_sum_us_ /
+                                                     this->waits_)
+                             : 0;
+  }
+  uint32_t wait_max_us() const { return this->wait_max_us_; }
+
+protected:
+  struct Pending {
+    uint8_t len;
+    uint32_t deadline_us;
+    uint8_t data[protocol::MAX_FRAME_LEN];
+  };
+
+  void start_backoff_();
+  void expire_(uint32_t now_us);
+  void clear_pending_() { this->pending_head_ = this->pending_tail_; }
+  uint32_t random_();
+
+  uint8_t node_id_{0};
+  uint32_t slot_spacing_us_{0};
+  uint32_t rng_{0x5A5A5A5A};
+  uint8_t max_retries_{3};
+
+  Pending pending_[MAX_PENDING];
+  uint8_t pending_head_{0};
+  uint8_t pending_tail_{0};
+  bool echo_seen_{false};
+
+  uint8_t backoff_exp_{0};
+  uint16_t backoff_cycles_{0};
+  bool waiting_{false};
+  uint32_t wait_start_us_{0};
+
+  volatile uint32_t attempts_{0};
+  volatile uint32_t confirmed_{0};
+  volatile uint32_t collisions_{0};
+  volatile uint32_t unconfirmed_{0};
+  volatile uint32_t deferred_{0};
+  volatile uint32_t retries_{0};
+  volatile uint32_t abandoned_{0};
+  uint64_t wait_sum_us_{0};
+  uint32_t waits_{0};
+  volatile uint32_t wait_max_us_{0};
+};
+
+} // namespace sauna360
+} // namespace esphome
@@ -0,0 +1,653 @@
+// Offline decoder for SAUNA360 bus captures.
+//
+// Reads raw UART captures (e.g. from sauna360_stream_client.py --raw or a
+// logic analyser export) and ESPHome DEBUG logs containing
+//   ... [ HEATER --> PANEL ] CODE 6000 DATA 0x0001A2B3
+// lines, and writes one CSV per input file plus statistics on stderr.
+// Frame decoding, CRC and field extraction are the component's own code.
+//
+// Inputs are cut into CHUNK_LEN pieces at frame (raw) or line (log)
+// boundaries, so one large capture is spread over all workers as well as
+// many small ones. Each chunk is decoded into memory and written out in
+// order by whichever worker completes the next one due.
+//
+// Build (Linux / macOS, from the repository root):
+//   g++ -O2 -std=c++17 -pthread -Iesphome/components -o sauna360_decode
+//       tools/sauna360_decode.cpp
+//       esphome/components/sauna360/custom_register.cpp
+//
+// Usage:
+//   sauna360_decode [-j N] [-o DIR] [--code XXXX] [--raw|--log] FILE...
+//
+// Default CSV columns: pos,dir,type,code,data,crc_ok,fields where `pos` is
+// the byte offset (raw) or the log timestamp, and `fields` lists the known
+// fields of that code as name=value pairs. With --code only that code is
+// written and each field gets its own column, which keeps the schema fixed
+// for Parquet / DataFrame import.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "sauna360/custom_register.h"
+#include "sauna360/sauna360_protocol.h"
+
+namespace proto = esphome::sauna360::protocol;
+using esphome::sauna360::CustomRegisters;
+
+namespace {
+
+// Known fields, same bit layout the component decodes in sauna360.cpp.
+struct KnownField {
+  uint16_t code;
+  const char *name;
+  uint8_t bit_offset;
+  uint8_t bit_width;
+  float scale;
+  float offset;
+};
+
+const KnownField KNOWN_FIELDS[] = {
+    {0x3400, "heating", 4, 1, 1, 0},
+    {0x4002, "bath_time_raw", 0, 12, 1, 0},
+    {0x4002, "max_bath_temp", 20, 12, 1.0f / 18, 0},
+    {0x4003, "pcb_limit", 11, 11, 1.0f / 18, 0},
+    {0x4200, "minute", 0, 6, 1, 0},
+    {0x4200, "hour", 6, 5, 1, 0},
+    {0x4200, "day", 12, 5, 1, 0},
+    {0x4200, "month", 17, 4, 1, 0},
+    {0x4200, "year", 21, 5, 1, 2000},
+    {0x6000, "temperature", 0, 11, 1.0f / 9, 0},
+    {0x6000, "setpoint", 11, 11, 1.0f / 9, 0},
+    {0x6001, "percent_mode", 28, 4, 1, 0},
+    {0x6001, "step_raw", 4, 8, 1, 0},
+    {0x6001, "target_pct", 7, 6, 1, 0},
+    {0x6001, "current_pct", 0, 7, 1, 0},
+    {0x7180, "relays", 0, 32, 1, 0},
+    {0x7280, "tank_level", 11, 2, 50, 0},
+    {0x9000, "from_min", 0, 6, 1, 0},
+    {0x9000, "from_hour", 6, 5, 1, 0},
+    {0x9000, "until_min", 11, 6, 1, 0},
+    {0x9000, "until_hour", 17, 5, 1, 0},
+    {0x9000, "active", 22, 1, 1, 0},
+    {0x9400, "uptime_min", 0, 32, 1, 0},
+    {0x9401, "remaining_min", 0, 16, 1, 0},
+    {0xB000, "door_open", 0, 1, 1, 0},
+    {0xB000, "door_code", 16, 8, 1, 0},
+};
+
+CustomRegisters::Field to_field(const KnownField &k) {
+  CustomRegisters::Field f{};
+  f.key = k.code;
+  f.bit_offset = k.bit_offset;
+  f.bit_width = k.bit_width;
+  f.is_signed = false;
+  f.scale = k.scale;
+  f.offset = k.offset;
+  return f;
+}
+
+enum class Format { AUTO, RAW, LOG };
+
+struct Options {
+  unsigned jobs{0};
+  std::string out_dir;
+  int code{-1};
+  Format format{Format::AUTO};
+  std::vector<std::string> files;
+};
+
+struct Stats {
+  uint64_t bytes{0};
+  uint64_t frames{0};
+  uint64_t crc_errors{0};
+  uint64_t malformed{0}; // oversize, truncated or too short
+  uint64_t skipped{0};   // bytes outside frames
+  uint64_t keepalives{0}; // panel acks (EOF markers) and heater polls
+  // [(direction << 16) | code] -> frames
+  std::vector<uint32_t> per_code = std::vector<uint32_t>(2 << 16);
+  double seconds{0};
+  std::string error;
+
+  void merge(const Stats &o) {
+    this->bytes += o.bytes;
+    this->frames += o.frames;
+    this->crc_errors += o.crc_errors;
+    this->malformed += o.malformed;
+    this->skipped += o.skipped;
+    this->keepalives += o.keepalives;
+    for (size_t i = 0; i < this->per_code.size(); i++)
+      this->per_code[i] += o.per_code[i];
+  }
+};
+
+// CSV text of one chunk, kept in memory until the chunk's turn to be
+// written; never shared between threads
+class CsvWriter {
+public:
+  explicit CsvWriter(std::string *buf) : buf_(*buf) {}
+
+  void str(const char *s, size_t n) { this->buf_.append(s, n); }
+  void str(const char *s) { this->str(s, strlen(s)); }
+  void u64(uint64_t v) {
+    char tmp[24];
+    const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    this->str(tmp, res.ptr - tmp);
+  }
+  void hex(uint32_t v, int digits) {
+    static const char DIGITS[] = "0123456789ABCDEF";
+    char tmp[8];
+    for (int i = digits - 1; i >= 0; i--, v >>= 4)
+      tmp[i] = DIGITS[v & 0xF];
+    this->str(tmp, digits);
+  }
+  void num(float v) {
+    char tmp[32];
+    const auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    this->str(tmp, res.ptr - tmp);
+  }
+
+protected:
+  std::string &buf_;
+};
+
+class Decoder {
+public:
+  // `header`: first chunk of the file
+  Decoder(const Options &opt, CsvWriter &out, Stats &stats, bool header)
+      : opt_(opt), out_(out), stats_(stats) {
+    for (const auto &k : KNOWN_FIELDS)
+      if (opt.code < 0 || k.code == opt.code)
+        this->fields_.push_back({k, to_field(k)});
+    if (header)
+      this->header_();
+  }
+
+  // `base`: file offset of p, for the pos column
+  void decode_raw(const uint8_t *p, size_t len, uint64_t base);
+  void decode_log(const char *p, size_t len);
+
+protected:
+  struct Entry {
+    KnownField known;
+    CustomRegisters::Field field;
+  };
+
+  void header_();
+  void value_(const Entry &e, uint32_t data);
+  void emit_(const char *pos, size_t pos_len, bool from_panel, uint8_t type,
+             uint16_t code, uint32_t data, int crc_ok);
+
+  const Options &opt_;
+  CsvWriter &out_;
+  Stats &stats_;
+  std::vector<Entry> fields_;
+};
+
+void Decoder::header_() {
+  this->out_.str("pos,dir,type,code,data,crc_ok");
+  if (this->opt_.code < 0) {
+    this->out_.str(",fields\n");
+    return;
+  }
+  for (const auto &e : this->fields_) {
+    this->out_.str(",");
+    this->out_.str(e.known.name);
+  }
+  this->out_.str("\n");
+}
+
+// Unscaled fields are written as integers so 32-bit counters stay exact
+void Decoder::value_(const Entry &e, uint32_t data) {
+  const uint32_t raw = CustomRegisters::extract(e.field, data);
+  if (e.known.scale == 1 && e.known.offset == 0)
+    this->out_.u64(raw);
+  else
+    this->out_.num(CustomRegisters::convert(e.field, raw));
+}
+
+void Decoder::emit_(const char *pos, size_t pos_len, bool from_panel,
+                    uint8_t type, uint16_t code, uint32_t data, int crc_ok) {
+  this->stats_.frames++;
+  this->stats_.per_code[(from_panel ? 1u << 16 : 0u) | code]++;
+  if (this->opt_.code >= 0 && code != this->opt_.code)
+    return;
+
+  this->out_.str(pos, pos_len);
+  this->out_.str(from_panel ? ",panel," : ",heater,");
+  this->out_.hex(type, 2);
+  this->out_.str(",");
+  this->out_.hex(code, 4);
+  this->out_.str(",");
+  this->out_.hex(data, 8);
+  this->out_.str(crc_ok < 0 ? "," : crc_ok ? ",1" : ",0");
+
+  if (this->opt_.code >= 0) {
+    for (const auto &e : this->fields_) {
+      this->out_.str(",");
+      this->value_(e, data);
+    }
+    this->out_.str("\n");
+    return;
+  }
+
+  this->out_.str(",");
+  bool first = true;
+  for (const auto &e : this->fields_) {
+    if (e.known.code != code)
+      continue;
+    if (!first)
+      this->out_.str(";");
+    first = false;
+    this->out_.str(e.known.name);
+    this->out_.str("=");
+    this->value_(e, data);
+  }
+  if (code == 0x4002) {
+    this->out_.str(";bath_time=");
+    this->out_.u64(proto::bath_time_minutes(data & 0x0FFF));
+  }
+  this->out_.str("\n");
+}
+
+// SOF is located with memchr (vectorised in every mainstream libc), the
+// EOF with a second memchr bounded to MAX_FRAME_LEN. Only the few bytes of
+// each frame are touched one at a time.
+void Decoder::decode_raw(const uint8_t *p, size_t len, uint64_t base) {
+  const uint8_t *end = p + len;
+  const uint8_t *cur = p;
+  while (cur < end) {
+    const auto *sof = static_cast<const uint8_t *>(
+        memchr(cur, proto::SOF, end - cur));
+    if (sof == nullptr) {
+      this->stats_.skipped += end - cur;
+      break;
+    }
+    this->stats_.skipped += sof - cur;
+    const size_t window =
+        std::min<size_t>(proto::MAX_FRAME_LEN, end - sof);
+    const auto *eof = static_cast<const uint8_t *>(
+        memchr(sof + 1, proto::EOF_BYTE, window - 1));
+    // A new SOF before the EOF means the previous frame was cut short
+    const auto *next_sof = static_cast<const uint8_t *>(memchr(
+        sof + 1, proto::SOF, (eof != nullptr ? eof : sof + window) - sof - 1));
+    if (eof == nullptr || next_sof != nullptr) {
+      this->stats_.malformed++;
+      cur = next_sof != nullptr ? next_sof : sof + window;
+      continue;
+    }
+    cur = eof + 1;
+
+    // Panel ack and heater poll: 6 bytes on the wire, no escapes
+    if (eof - sof == 5 &&
+        (memcmp(sof, proto::PANEL_ACK, sizeof(proto::PANEL_ACK)) == 0 ||
+         memcmp(sof, proto::HEATER_POLL, sizeof(proto::HEATER_POLL)) == 0)) {
+      this->stats_.keepalives++;
+      continue;
+    }
+    uint8_t packet[proto::PAYLOAD_LEN + 2];
+    const size_t n = proto::unescape_frame(sof, eof + 1 - sof, packet);
+    if (n != sizeof(packet) || packet[0] != proto::ADDRESS) {
+      this->stats_.malformed++;
+      continue;
+    }
+    const uint16_t crc = static_cast<uint16_t>(packet[8] << 8 | packet[9]);
+    const bool crc_ok = proto::crc16(packet, proto::PAYLOAD_LEN) == crc;
+    if (!crc_ok)
+      this->stats_.crc_errors++;
+
+    const uint8_t type = packet[1];
+    const uint16_t code = static_cast<uint16_t>(packet[2] << 8 | packet[3]);
+    const uint32_t data = static_cast<uint32_t>(packet[4]) << 24 |
+                          static_cast<uint32_t>(packet[5]) << 16 |
+                          static_cast<uint32_t>(packet[6]) << 8 | packet[7];
+    char pos[24];
+    const auto res = std::to_chars(pos, pos + sizeof(pos),
+                                   base + static_cast<uint64_t>(sof - p));
+    this->emit_(pos, res.ptr - pos, type == 0x07 || type == 0x09, type, code, data,
+                crc_ok);
+  }
+}
+
+bool parse_hex(const char *s, int digits, uint32_t *out) {
+  uint32_t v = 0;
+  for (int i = 0; i < digits; i++) {
+    const char c = s[i];
+    v <<= 4;
+    if (c >= '0' && c <= '9')
+      v |= c - '0';
+    else if (c >= 'A' && c <= 'F')
+      v |= c - 'A' + 10;
+    else if (c >= 'a' && c <= 'f')
+      v |= c - 'a' + 10;
+    else
+      return false;
+  }
+  *out = v;
+  return true;
+}
+
+// Matches the ESP_LOGD lines in SAUNA360Component::handle_packet_:
+//   [12:00:01][D][sauna360:395]: 40.06.60.00.00.01.A2.B3 [ HEATER --> PANEL ]
+//   CODE 6000 DATA 0x0001A2B3
+void Decoder::decode_log(const char *p, size_t len) {
+  static const char MARK[] = "[ HEATER ";
+  static const size_t MARK_LEN = sizeof(MARK) - 1;
+  const char *end = p + len;
+  const char *line = p;
+  while (line < end) {
+    const char *eol = static_cast<const char *>(memchr(line, '\n', end - line));
+    if (eol == nullptr)
+      eol = end;
+    const char *mark = static_cast<const char *>(
+        memmem(line, eol - line, MARK, MARK_LEN));
+    if (mark == nullptr) {
+      this->stats_.skipped += eol - line;
+      line = eol + 1;
+      continue;
+    }
+
+    // "--> PANEL ] CODE xxxx DATA 0xXXXXXXXX"
+    const char *s = mark + MARK_LEN;
+    uint32_t code = 0, data = 0, type = 0;
+    if (eol - s < 37 || memcmp(s + 10, "] CODE ", 7) != 0 ||
+        memcmp(s + 21, " DATA 0x", 8) != 0 || !parse_hex(s + 17, 4, &code) ||
+        !parse_hex(s + 29, 8, &data)) {
+      this->stats_.malformed++;
+      line = eol + 1;
+      continue;
+    }
+    const bool from_panel = s[0] == '<';
+    // Type is the second byte of the "40.TT.CC.CC..." dump before the mark
+    if (mark - line >= 24 && mark[-24] == '4' && mark[-23] == '0')
+      parse_hex(mark - 21, 2, &type);
+    else
+      type = from_panel ? 0x07 : 0x06;
+
+    // Logger timestamp "[hh:mm:ss]" or "[hh:mm:ss.mmm]" at line start
+    const char *pos = line;
+    size_t pos_len = 0;
+    if (line[0] == '[') {
+      const char *close =
+          static_cast<const char *>(memchr(line, ']', mark - line));
+      if (close != nullptr && close - line <= 16) {
+        pos = line + 1;
+        pos_len = close - line - 1;
+      }
+    }
+    this->emit_(pos, pos_len, from_panel, static_cast<uint8_t>(type),
+                static_cast<uint16_t>(code), data, -1);
+    line = eol + 1;
+  }
+}
+
+Format detect(const uint8_t *p, size_t len) {
+  const size_t n = std::min<size_t>(len, 64 * 1024);
+  return memmem(p, n, "] CODE ", 7) != nullptr ? Format::LOG : Format::RAW;
+}
+
+std::string output_path(const Options &opt, const std::string &in) {
+  std::string base = in;
+  if (!opt.out_dir.empty()) {
+    const size_t slash = in.find_last_of('/');
+    base = opt.out_dir + "/" +
+           (slash == std::string::npos ? in : in.substr(slash + 1));
+  }
+  if (opt.code >= 0) {
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), ".%04X", opt.code);
+    base += suffix;
+  }
+  return base + ".csv";
+}
+
+// Input size per task. Small enough to spread one capture over all cores,
+// large enough that the per-chunk setup does not show.
+constexpr size_t CHUNK_LEN = 4 << 20;
+
+struct Chunk {
+  std::string csv;
+  Stats stats;
+};
+
+// One input file: its mapping, output and the chunks still to be written
+struct FileJob {
+  std::string path;
+  const uint8_t *data{nullptr};
+  size_t len{0};
+  Format format{Format::RAW};
+  FILE *out{nullptr};
+  Stats stats;
+
+  std::mutex lock;
+  std::vector<std::unique_ptr<Chunk>> done; // decoded, not written yet
+  size_t next_write{0};
+  bool started{false};
+  std::chrono::steady_clock::time_point start;
+};
+
+struct Task {
+  FileJob *file;
+  size_t index;
+  size_t begin;
+  size_t end;
+};
+
+// Cut points: raw captures at an SOF, logs after a newline, so every frame
+// and line falls into exactly one chunk. An SOF is never escaped, so it
+// always starts a frame; the decoder resyncs on it the same way.
+std::vector<size_t> split(const uint8_t *p, size_t len, Format fmt) {
+  const int sep = fmt == Format::LOG ? '\n' : proto::SOF;
+  const size_t after = fmt == Format::LOG ? 1 : 0;
+  std::vector<size_t> cuts{0};
+  for (size_t at = CHUNK_LEN; at < len; at = cuts.back() + CHUNK_LEN) {
+    const auto *hit = static_cast<const uint8_t *>(memchr(p + at, sep, len - at));
+    if (hit == nullptr || static_cast<size_t>(hit - p) + after >= len)
+      break;
+    cuts.push_back(hit - p + after);
+  }
+  cuts.push_back(len);
+  return cuts;
+}
+
+// Maps the input, opens the output and queues its chunks
+void open_file(const Options &opt, FileJob &f, std::vector<Task> &tasks) {
+  const int fd = open(f.path.c_str(), O_RDONLY);
+  struct stat st {};
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    f.stats.error = strerror(errno);
+    if (fd >= 0)
+      close(fd);
+    return;
+  }
+  f.len = static_cast<size_t>(st.st_size);
+  if (f.len != 0) {
+    void *map = mmap(nullptr, f.len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+      f.stats.error = strerror(errno);
+      close(fd);
+      return;
+    }
+    madvise(map, f.len, MADV_SEQUENTIAL);
+    f.data = static_cast<const uint8_t *>(map);
+  }
+  close(fd);
+
+  const std::string out_path = output_path(opt, f.path);
+  f.out = fopen(out_path.c_str(), "w");
+  if (f.out == nullptr) {
+    f.stats.error = out_path + ": " + strerror(errno);
+    if (f.data != nullptr)
+      munmap(const_cast<uint8_t *>(f.data), f.len);
+    return;
+  }
+  f.format = opt.format == Format::AUTO ? detect(f.data, f.len) : opt.format;
+  const std::vector<size_t> cuts = split(f.data, f.len, f.format);
+  f.done.resize(cuts.size() - 1);
+  for (size_t i = 0; i + 1 < cuts.size(); i++)
+    tasks.push_back({&f, i, cuts[i], cuts[i + 1]});
+}
+
+// Decodes one chunk, then writes every chunk of the file that is due
+void run_task(const Options &opt, const Task &t) {
+  FileJob &f = *t.file;
+  {
+    std::lock_guard<std::mutex> guard(f.lock);
+    if (!f.started) {
+      f.started = true;
+      f.start = std::chrono::steady_clock::now();
+    }
+  }
+
+  auto chunk = std::make_unique<Chunk>();
+  chunk->csv.reserve((t.end - t.begin) * 3);
+  {
+    CsvWriter csv(&chunk->csv);
+    Decoder decoder(opt, csv, chunk->stats, t.index == 0);
+    if (f.format == Format::LOG)
+      decoder.decode_log(reinterpret_cast<const char *>(f.data) + t.begin,
+                         t.end - t.begin);
+    else
+      decoder.decode_raw(f.data + t.begin, t.end - t.begin, t.begin);
+  }
+  chunk->stats.bytes = t.end - t.begin;
+
+  std::lock_guard<std::mutex> guard(f.lock);
+  f.done[t.index] = std::move(chunk);
+  while (f.next_write < f.done.size() && f.done[f.next_write] != nullptr) {
+    Chunk &c = *f.done[f.next_write];
+    fwrite(c.csv.data(), 1, c.csv.size(), f.out);
+    f.stats.merge(c.stats);
+    f.done[f.next_write].reset();
+    f.next_write++;
+  }
+  if (f.next_write == f.done.size()) {
+    fclose(f.out);
+    f.out = nullptr;
+    munmap(const_cast<uint8_t *>(f.data), f.len);
+    f.data = nullptr;
+    f.stats.seconds = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - f.start)
+                          .count();
+  }
+}
+
+void usage() {
+  fprintf(stderr,
+          "usage: sauna360_decode [-j N] [-o DIR] [--code XXXX] [--raw|--log] "
+          "FILE...\n");
+  exit(2);
+}
+
+Options parse_args(int argc, char **argv) {
+  Options opt;
+  for (int i = 1; i < argc; i++) {
+    const std::string a = argv[i];
+    if (a == "-j" && i + 1 < argc) {
+      opt.jobs = static_cast<unsigned>(atoi(argv[++i]));
+    } else if (a == "-o" && i + 1 < argc) {
+      opt.out_dir = argv[++i];
+    } else if (a == "--code" && i + 1 < argc) {
+      uint32_t code;
+      if (strlen(argv[++i]) != 4 || !parse_hex(argv[i], 4, &code))
+        usage();
+      opt.code = static_cast<int>(code);
+    } else if (a == "--raw") {
+      opt.format = Format::RAW;
+    } else if (a == "--log") {
+      opt.format = Format::LOG;
+    } else if (!a.empty() && a[0] == '-') {
+      usage();
+    } else {
+      opt.files.push_back(a);
+    }
+  }
+  if (opt.files.empty())
+    usage();
+  if (opt.jobs == 0)
+    opt.jobs = std::max(1u, std::thread::hardware_concurrency());
+  return opt;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opt = parse_args(argc, argv);
+  std::vector<FileJob> files(opt.files.size());
+  std::vector<Task> tasks;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < files.size(); i++) {
+    files[i].path = opt.files[i];
+    open_file(opt, files[i], tasks);
+  }
+  opt.jobs = static_cast<unsigned>(
+      std::max<size_t>(1, std::min<size_t>(opt.jobs, tasks.size())));
+
+  // Tasks go out in file and chunk order, which keeps the chunks waiting
+  // to be written to about one per worker
+  std::atomic<size_t> next{0};
+  std::vector<std::thread> workers;
+  for (unsigned j = 0; j < opt.jobs; j++) {
+    workers.emplace_back([&] {
+      for (size_t i; (i = next.fetch_add(1)) < tasks.size();)
+        run_task(opt, tasks[i]);
+    });
+  }
+  for (auto &w : workers)
+    w.join();
+  const double wall = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+  int rc = 0;
+  Stats total;
+  fprintf(stderr, "%-32s %12s %10s %10s %8s %8s %10s\n", "file", "bytes",
+          "frames", "keepalive", "crc_err", "bad", "MB/s");
+  for (size_t i = 0; i < files.size(); i++) {
+    const Stats &s = files[i].stats;
+    if (!s.error.empty()) {
+      fprintf(stderr, "%-32s error: %s\n", opt.files[i].c_str(),
+              s.error.c_str());
+      rc = 1;
+      continue;
+    }
+    fprintf(stderr,
+            "%-32s %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %8" PRIu64
+            " %8" PRIu64 " %10.1f\n",
+            opt.files[i].c_str(), s.bytes, s.frames, s.keepalives,
+            s.crc_errors, s.malformed, s.seconds > 0 ? s.bytes / s.seconds / 1e6 : 0.0);
+    total.merge(s);
+  }
+  fprintf(stderr,
+          "%-32s %12" PRIu64 " %10" PRIu64 " %10" PRIu64 " %8" PRIu64
+          " %8" PRIu64 " %10.1f  (%u threads)\n",
+          "total", total.bytes, total.frames, total.keepalives,
+          total.crc_errors, total.malformed, wall > 0 ? total.bytes / wall / 1e6 : 0.0,
+          opt.jobs);
+
+  fprintf(stderr, "\n%-8s %-6s %12s\n", "dir", "code", "frames");
+  for (size_t key = 0; key < total.per_code.size(); key++) {
+    if (total.per_code[key] != 0)
+      fprintf(stderr, "%-8s %04X   %12" PRIu32 "\n",
+              (key >> 16) ? "panel" : "heater",
+              static_cast<unsigned>(key & 0xFFFF), total.per_code[key]);
+  }
+  return rc;
+}
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Host test: no heap allocations in steady state (heap_audit).
+
+Builds a `platform: host` configuration with `heap_audit: true`, connects it
+to the heater emulator through a PTY pair and reads the log. The component
+compares its allocation counters once per diagnostics interval (60 s); the
+first interval covers start-up. The test passes after `--intervals` clean
+intervals and fails on the first "allocations in steady state" warning, or
+if the counters are never reported.
+
+Requires esphome, socat and pyserial (for the emulator). Run from anywhere:
+
+    python3 tools/sauna360_heap_audit_test.py [--intervals 3] [--panel]
+
+Without --panel the node runs as virtual panel and answers every poll, which
+covers the TX path as well; with --panel the emulator acks and the node
+only listens.
+"""
+
+import argparse
+import os
+import re
+import select
+import signal
+import subprocess
+import sys
+import tempfile
+import time
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+COMPONENTS = os.path.join(os.path.dirname(TOOLS), "esphome", "components")
+DIAG_INTERVAL_S = 60
+
+CONFIG = """\
+esphome:
+  name: sauna360-heap-audit
+
+host:
+
+logger:
+  level: DEBUG
+
+external_components:
+  - source:
+      type: local
+      path: {components}
+    components: [sauna360]
+
+sauna360:
+  device: {device}
+  virtual_panel: {virtual_panel}
+  adaptive_ifg: true
+  heap_audit: true
+
+sensor:
+  - platform: sauna360
+    current_temperature:
+      name: Temperature
+    rx_stack_free:
+      name: RX stack free
+
+text_sensor:
+  - platform: sauna360
+    heater_state:
+      name: Heater state
+    latency:
+      name: Latency
+    ifg_histogram:
+      name: IFG histogram
+"""
+
+RUNNING = re.compile(r"\[[EWICDV]\]\[sauna360")  # first component log line
+CLEAN = re.compile(r"Heap audit: no allocations")
+DIRTY = re.compile(r"Heap audit: (\d+) RX / (\d+) loop allocations")
+
+
+def start(args, **kwargs):
+    return subprocess.Popen(args, start_new_session=True, **kwargs)
+
+
+def stop(proc):
+    if proc.poll() is None:
+        os.killpg(proc.pid, signal.SIGTERM)
+        try:
+            proc.wait(timeout=10)
+        except subprocess.TimeoutExpired:
+            os.killpg(proc.pid, signal.SIGKILL)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--intervals", type=int, default=3,
+                        help="clean diagnostics intervals needed to pass")
+    parser.add_argument("--panel", action="store_true",
+                        help="emulator acks the polls, node only listens")
+    parser.add_argument("--build-timeout", type=float, default=900, help="s")
+    args = parser.parse_args()
+
+    work = tempfile.mkdtemp(prefix="sauna360-heap-audit-")
+    bus = os.path.join(work, "bus")
+    heater = os.path.join(work, "heater")
+    config = os.path.join(work, "heap-audit.yaml")
+    with open(config, "w") as f:
+        f.write(CONFIG.format(components=COMPONENTS, device=bus,
+                              virtual_panel="false" if args.panel else "true"))
+
+    procs = []
+    try:
+        procs.append(start(["socat", f"pty,raw,echo=0,link={bus}",
+                            f"pty,raw,echo=0,link={heater}"]))
+        for _ in range(50):
+            if os.path.exists(bus) and os.path.exists(heater):
+                break
+            time.sleep(0.1)
+        else:
+            print("FAIL: socat did not create the PTY pair")
+            return 1
+        emulator = [sys.executable, os.path.join(TOOLS, "sauna360_heater_emulator.py"),
+                    heater] + (["--panel"] if args.panel else [])
+        heater_proc = start(emulator, stdout=subprocess.DEVNULL)
+        procs.append(heater_proc)
+
+        node = start(["esphome", "run", config], stdout=subprocess.PIPE,
+                     stderr=subprocess.STDOUT, text=True)
+        procs.append(node)
+
+        # Build time first, then one interval of warm-up plus the clean ones
+        deadline = time.monotonic() + args.build_timeout
+        clean = 0
+        running = False
+        while time.monotonic() < deadline:
+            ready, _, _ = select.select([node.stdout], [], [], 1.0)
+            if not ready:
+                continue
+            line = node.stdout.readline()
+            if not line:
+                break  # node exited
+            if heater_proc.poll() is not None:
+                print("FAIL: heater emulator exited, the bus is silent")
+                return 1
+            if not running and RUNNING.search(line):
+                running = True
+                deadline = time.monotonic() + (args.intervals + 2) * DIAG_INTERVAL_S
+            if m := DIRTY.search(line):
+                print(line.rstrip())
+                print(f"FAIL: {m.group(1)} RX / {m.group(2)} loop allocations "
+                      "in steady state")
+                return 1
+            if CLEAN.search(line):
+                clean += 1
+                print(f"interval {clean}/{args.intervals}: no allocations", flush=True)
+                if clean >= args.intervals:
+                    print("PASS")
+                    return 0
+        print(f"FAIL: {clean} of {args.intervals} clean intervals seen "
+              f"(node {'exited' if node.poll() is not None else 'timed out'})")
+        return 1
+    finally:
+        for proc in reversed(procs):
+            stop(proc)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,196 @@
+#!/usr/bin/env python3
+"""Minimal SAUNA360 heater emulator for bench tests.
+
+Plays the heater side of the bus on a USB RS-485 adapter (or any serial
+port, e.g. a PTY pair): polls every cycle, sends one status register per
+cycle and applies the panel commands it receives (setpoint, heater / light
+toggles, bath time). Requires pyserial.
+
+    # ESP in virtual panel mode: the emulator is the heater only
+    sauna360_heater_emulator.py /dev/ttyUSB0
+
+    # Shared mode: the emulator also plays the physical panel and acks
+    # every poll, so the ESP has to wait for the panel EOF
+    sauna360_heater_emulator.py /dev/ttyUSB0 --panel
+
+Run the same automation in both modes and compare the `tx_latency` sensor
+(or the `tx_wait` line of the `latency` text sensor) on the ESP. The
+emulator itself prints, per command, how many polls it took to arrive after
+the previous command and the reply delay after the poll.
+"""
+
+import argparse
+import time
+
+import serial
+
+SOF, EOF, ESC = 0x98, 0x9C, 0x91
+HEATER_POLL = bytes([0x98, 0x40, 0x06, 0x6D, 0x3A, 0x9C])
+PANEL_ACK = bytes([0x98, 0x40, 0x07, 0xFD, 0xE3, 0x9C])
+
+LIGHT_MASK = 0x00020000  # PURE model layout
+COILS_MASK = 0x0001C000
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x90D9) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def encode(type_, code, data):
+    payload = bytes([0x40, type_, code >> 8, code & 0xFF]) + data.to_bytes(4, "big")
+    crc = crc16(payload)
+    out = bytearray([SOF])
+    for b in payload + bytes([crc >> 8, crc & 0xFF]):
+        out += bytes([ESC, ~b & 0xFF]) if b in (SOF, EOF, ESC) else bytes([b])
+    out.append(EOF)
+    return bytes(out)
+
+
+def decode(frame):
+    """Returns (type, code, data) or None for acks and bad frames."""
+    payload = bytearray()
+    escaped = False
+    for b in frame[1:-1]:
+        if b == ESC and not escaped:
+            escaped = True
+            continue
+        payload.append(~b & 0xFF if escaped else b)
+        escaped = False
+    if len(payload) != 10 or crc16(payload[:8]) != (payload[8] << 8 | payload[9]):
+        return None
+    return payload[1], payload[2] << 8 | payload[3], int.from_bytes(payload[4:8], "big")
+
+
+class Heater:
+    def __init__(self):
+        self.temperature = 22.0
+        self.setpoint = 80
+        self.heater_on = False
+        self.light_on = False
+        self.bath_time_raw = 360
+        self.uptime_min = 1234
+        self.started = None
+
+    def registers(self):
+        relays = (LIGHT_MASK if self.light_on else 0) | (COILS_MASK if self.heater_on else 0)
+        remaining = 0xFFFF
+        if self.heater_on and self.started is not None:
+            remaining = max(0, self.bath_time_raw - int((time.monotonic() - self.started) / 60))
+        return [
+            (0x6000, (self.setpoint * 9) << 11 | int(self.temperature * 9)),
+            (0x3400, 0x10 if self.heater_on else 0),
+            (0x7180, relays),
+            (0x4002, self.bath_time_raw),
+            (0x9400, self.uptime_min),
+            (0x9401, remaining),
+        ]
+
+    def step(self, dt):
+        target = self.setpoint if self.heater_on else 22.0
+        self.temperature += (target - self.temperature) * min(1.0, dt / 120)
+
+    def apply(self, code, data):
+        if code == 0x6000:
+            self.setpoint = ((data >> 11) & 0x7FF) // 9
+            return f"setpoint {self.setpoint} C"
+        if code == 0x7000 and data == 0x1:
+            self.heater_on = not self.heater_on
+            self.started = time.monotonic() if self.heater_on else None
+            return f"heater {'on' if self.heater_on else 'off'}"
+        if code == 0x7000 and data == 0x2:
+            self.light_on = not self.light_on
+            return f"light {'on' if self.light_on else 'off'}"
+        if code == 0x4002:
+            self.bath_time_raw = data & 0x0FFF
+            return f"bath time raw {self.bath_time_raw}"
+        return f"ignored {code:04X} {data:08X}"
+
+
+def read_frames(port, window):
+    """Collects complete frames until the bus has been idle for `window` s."""
+    buf = bytearray()
+    frames = []
+    first = None
+    deadline = time.monotonic() + window
+    while time.monotonic() < deadline:
+        chunk = port.read(port.in_waiting or 1)
+        if not chunk:
+            continue
+        if first is None:
+            first = time.monotonic()
+        buf += chunk
+        deadline = time.monotonic() + window
+        while SOF in buf and EOF in buf[buf.index(SOF):]:
+            start = buf.index(SOF)
+            end = buf.index(EOF, start)
+            frames.append(bytes(buf[start:end + 1]))
+            del buf[:end + 1]
+    return frames, first
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port")
+    parser.add_argument("--cycle", type=float, default=0.25, help="poll period, s")
+    parser.add_argument("--panel", action="store_true", help="also act as the panel")
+    args = parser.parse_args()
+
+    port = serial.Serial(args.port, 19200, parity=serial.PARITY_EVEN, timeout=0.002)
+    heater = Heater()
+    polls = since_cmd = acks = 0
+    regs = 0
+    last = time.monotonic()
+    try:
+        while True:
+            now = time.monotonic()
+            heater.step(now - last)
+            last = now
+
+            port.write(HEATER_POLL)
+            port.flush()
+            sent = time.monotonic()
+            polls += 1
+            since_cmd += 1
+            if args.panel:
+                time.sleep(0.0006)
+                port.write(PANEL_ACK)
+                port.flush()
+
+            frames, first = read_frames(port, 0.02)
+            for frame in frames:
+                if frame in (PANEL_ACK, HEATER_POLL):
+                    acks += frame == PANEL_ACK and not args.panel
+                    continue
+                decoded = decode(frame)
+                if decoded is None:
+                    print(f"bad frame {frame.hex(' ')}", flush=True)
+                    continue
+                type_, code, data = decoded
+                if type_ not in (0x07, 0x09):
+                    continue  # our own echo
+                what = heater.apply(code, data)
+                delay_ms = (first - sent) * 1000 if first else 0
+                print(
+                    f"poll {polls:6d}: {what:24s} after {since_cmd} poll(s), "
+                    f"reply {delay_ms:.1f} ms",
+                    flush=True,
+                )
+                since_cmd = 0
+
+            code, data = heater.registers()[regs]
+            regs = (regs + 1) % len(heater.registers())
+            port.write(encode(0x06, code, data))
+            port.flush()
+
+            time.sleep(max(0.0, args.cycle - (time.monotonic() - now)))
+    except KeyboardInterrupt:
+        print(f"\n{polls} polls, {acks} acks")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,192 @@
+// Host test and benchmark for the wire format in sauna360_protocol.h.
+//
+// Round trip: every byte value in every payload position (type, code, data)
+// and in both CRC positions is encoded, checked for raw 0x98 / 0x9C inside
+// the frame and unescaped again. The benchmark then times encode_frame and
+// unescape_frame + crc16 on varied frames.
+//
+// Build and run (from the repository root):
+//   g++ -O2 -std=c++17 -Iesphome/components -o sauna360_protocol_test
+//       tools/sauna360_protocol_test.cpp
+//   ./sauna360_protocol_test [--frames N]
+//
+// Exits non-zero on the first failed check.
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "sauna360/sauna360_protocol.h"
+
+namespace proto = esphome::sauna360::protocol;
+
+namespace {
+
+unsigned failures = 0;
+
+void fail(const char *what, uint8_t type, uint16_t code, uint32_t data) {
+  if (failures++ < 10)
+    fprintf(stderr, "FAIL %s: type %02X code %04X data %08" PRIX32 "\n", what,
+            type, code, data);
+}
+
+// Encodes, checks the framing and decodes back. Returns the CRC.
+uint16_t round_trip(uint8_t type, uint16_t code, uint32_t data) {
+  uint8_t frame[proto::MAX_FRAME_LEN];
+  const size_t len = proto::encode_frame(type, code, data, frame);
+  if (len < 12 || len > proto::MAX_FRAME_LEN) {
+    fail("length", type, code, data);
+    return 0;
+  }
+  if (frame[0] != proto::SOF || frame[len - 1] != proto::EOF_BYTE)
+    fail("SOF/EOF", type, code, data);
+  for (size_t i = 1; i + 1 < len; i++) {
+    if (frame[i] == proto::SOF || frame[i] == proto::EOF_BYTE)
+      fail("raw SOF/EOF inside the frame", type, code, data);
+    if (frame[i] == proto::ESC &&
+        !proto::needs_escape(proto::unescape_byte(frame[++i])))
+      fail("bad escape", type, code, data);
+  }
+
+  const uint8_t expected[proto::PAYLOAD_LEN] = {
+      proto::ADDRESS,
+      type,
+      static_cast<uint8_t>(code >> 8),
+      static_cast<uint8_t>(code),
+      static_cast<uint8_t>(data >> 24),
+      static_cast<uint8_t>(data >> 16),
+      static_cast<uint8_t>(data >> 8),
+      static_cast<uint8_t>(data),
+  };
+  uint8_t packet[proto::PAYLOAD_LEN + 2];
+  if (proto::unescape_frame(frame, len, packet) != sizeof(packet)) {
+    fail("unescaped length", type, code, data);
+    return 0;
+  }
+  if (memcmp(packet, expected, proto::PAYLOAD_LEN) != 0)
+    fail("payload mismatch", type, code, data);
+  const uint16_t crc = static_cast<uint16_t>(packet[8] << 8 | packet[9]);
+  if (crc != proto::crc16(expected, proto::PAYLOAD_LEN))
+    fail("CRC mismatch", type, code, data);
+  return crc;
+}
+
+// Payload bytes 1..7 (the address is fixed) through all 256 values, with
+// the other bytes set to escapable values as well
+void test_payload_positions() {
+  for (int pos = 1; pos < static_cast<int>(proto::PAYLOAD_LEN); pos++) {
+    for (int v = 0; v < 256; v++) {
+      uint8_t p[proto::PAYLOAD_LEN] = {proto::ADDRESS, 0x07, 0x98, 0x9C,
+                                       0x91, 0x00, 0xFF, 0x98};
+      p[pos] = static_cast<uint8_t>(v);
+      round_trip(p[1], static_cast<uint16_t>(p[2] << 8 | p[3]),
+                 static_cast<uint32_t>(p[4]) << 24 |
+                     static_cast<uint32_t>(p[5]) << 16 |
+                     static_cast<uint32_t>(p[6]) << 8 | p[7]);
+    }
+  }
+}
+
+// Both CRC bytes through all 256 values: search data words until each value
+// has turned up in each position
+void test_crc_positions() {
+  bool seen[2][256] = {};
+  unsigned left = 512;
+  for (uint32_t data = 0; left != 0 && data < 0x01000000; data++) {
+    const uint16_t crc = round_trip(0x07, 0x6000, data * 2654435761u);
+    for (int i = 0; i < 2; i++) {
+      const uint8_t b = static_cast<uint8_t>(i == 0 ? crc >> 8 : crc);
+      if (!seen[i][b]) {
+        seen[i][b] = true;
+        left--;
+      }
+    }
+  }
+  if (left != 0) {
+    fprintf(stderr, "FAIL CRC coverage: %u values not reached\n", left);
+    failures++;
+  }
+}
+
+// Unknown escape codes must not decode to a frame byte that passes the CRC
+void test_bad_escape() {
+  uint8_t frame[proto::MAX_FRAME_LEN];
+  const size_t len = proto::encode_frame(0x07, 0x6000, 0x98000000u, frame);
+  for (size_t i = 1; i + 1 < len; i++) {
+    if (frame[i] != proto::ESC)
+      continue;
+    uint8_t broken[proto::MAX_FRAME_LEN];
+    memcpy(broken, frame, len);
+    broken[i + 1] = 0x00;
+    uint8_t packet[proto::PAYLOAD_LEN + 2];
+    const size_t n = proto::unescape_frame(broken, len, packet);
+    if (n == sizeof(packet) &&
+        proto::crc16(packet, proto::PAYLOAD_LEN) ==
+            static_cast<uint16_t>(packet[8] << 8 | packet[9])) {
+      fprintf(stderr, "FAIL unknown escape accepted\n");
+      failures++;
+    }
+  }
+}
+
+void benchmark(uint32_t count) {
+  using clock = std::chrono::steady_clock;
+  static uint8_t frames[4096][proto::MAX_FRAME_LEN];
+  static size_t lens[4096];
+  uint32_t x = 0x12345678;
+  uint64_t sink = 0;
+
+  auto t0 = clock::now();
+  for (uint32_t i = 0; i < count; i++) {
+    x = x * 1664525u + 1013904223u;
+    const uint32_t slot = i & 4095;
+    lens[slot] = proto::encode_frame(0x06, static_cast<uint16_t>(x >> 16), x,
+                                     frames[slot]);
+    sink += lens[slot];
+  }
+  auto t1 = clock::now();
+  for (uint32_t i = 0; i < count; i++) {
+    const uint32_t slot = i & 4095;
+    uint8_t packet[proto::PAYLOAD_LEN + 2];
+    const size_t n = proto::unescape_frame(frames[slot], lens[slot], packet);
+    sink += proto::crc16(packet, n - 2) == (packet[8] << 8 | packet[9]);
+  }
+  auto t2 = clock::now();
+
+  const double enc = std::chrono::duration<double>(t1 - t0).count();
+  const double dec = std::chrono::duration<double>(t2 - t1).count();
+  printf("encode: %u frames in %.3f s, %.1f M frames/s\n", (unsigned)count,
+         enc, count / enc / 1e6);
+  printf("decode: %u frames in %.3f s, %.1f M frames/s (checksum %" PRIu64
+         ")\n",
+         (unsigned)count, dec, count / dec / 1e6, sink);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  uint32_t frames = 10000000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      frames = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+    } else {
+      fprintf(stderr, "usage: %s [--frames N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  test_payload_positions();
+  test_crc_positions();
+  test_bad_escape();
+  if (failures != 0) {
+    fprintf(stderr, "%u check(s) failed\n", failures);
+    return 1;
+  }
+  printf("round trip: all byte values in payload and CRC positions ok\n");
+
+  if (frames != 0)
+    benchmark(frames);
+  return 0;
+}
@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Reader for sauna360 flight recorder captures (``flight_recorder:`` in YAML).
+
+Reads either a dump of the recorder partition or an ESPHome log with the
+output of ``sauna360.recorder_dump``, and prints every capture: one line per
+frame with its time relative to the trigger, and the decoded state
+snapshots in between.
+
+    parttool.py read_partition --partition-name sauna_recorder --output rec.bin
+    sauna360_recorder.py rec.bin
+    sauna360_recorder.py device.log --raw out/
+
+With ``--raw`` the wire bytes of each capture are written to
+``DIR/capture_<seq>.bin``, in the same format as a UART capture, for
+``sauna360_decode``.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+MAGIC = 0x52363353  # "S36R"
+VERSION = 1
+SECTOR = 4096
+HEADER = struct.Struct("<IBBHIIIIIHH")
+RECORD = struct.Struct("<BBHI24s")
+SNAPSHOT = struct.Struct("<HHHBB16s")
+
+REC_VALID = 0x01
+REC_PANEL = 0x02
+REC_TX = 0x04
+REC_TRUNC = 0x08
+REC_SNAPSHOT = 0x10
+
+SNAP_FLAGS = ("heater", "light", "session", "heating", "bus_up")
+REASONS = ("manual", "code", "crc_burst", "heater_state")
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x90D9) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+class Capture:
+    def __init__(self, seq, unix_time, reason, code, data, trigger_us, trigger_index):
+        self.seq = seq
+        self.unix_time = unix_time
+        self.reason = reason
+        self.code = code
+        self.data = data
+        self.trigger_us = trigger_us
+        self.trigger_index = trigger_index
+        self.records = []  # (flags, seq, time_us, bytes)
+
+
+def parse_image(blob):
+    """Captures in a partition image; headers sit on 4 KiB boundaries."""
+    captures = []
+    offset = 0
+    while offset + HEADER.size <= len(blob):
+        raw = blob[offset : offset + HEADER.size]
+        (magic, version, reason, code, seq, unix_time, trigger_us, data, count,
+         trigger_index, crc) = HEADER.unpack(raw)
+        if magic != MAGIC or version != VERSION or crc != crc16(raw[:-2]):
+            offset += SECTOR
+            continue
+        cap = Capture(seq, unix_time, REASONS[reason] if reason < len(REASONS)
+                      else str(reason), code, data, trigger_us, trigger_index)
+        pos = offset + HEADER.size
+        for _ in range(count):
+            length, flags, rseq, time_us, payload = RECORD.unpack_from(blob, pos)
+            cap.records.append((flags, rseq, time_us, payload[:length]))
+            pos += RECORD.size
+        captures.append(cap)
+        offset += (HEADER.size + count * RECORD.size + SECTOR - 1) // SECTOR * SECTOR
+    return captures
+
+
+CAP_RE = re.compile(r"recorder: cap (\d+),(\d+),(\w+),([0-9A-F]{4}),([0-9A-F]{8}),(\d+),(\d+),(\d+)")
+REC_RE = re.compile(r"recorder: rec ([0-9A-F]+)")
+
+
+def parse_log(text):
+    captures = []
+    for line in text.splitlines():
+        m = CAP_RE.search(line)
+        if m:
+            seq, unix_time, reason, code, data, trigger_us, _count, index = m.groups()
+            captures.append(Capture(int(seq), int(unix_time), reason, int(code, 16),
+                                    int(data, 16), int(trigger_us), int(index)))
+            continue
+        m = REC_RE.search(line)
+        if m and captures:
+            raw = bytes.fromhex(m.group(1))
+            length, flags, rseq, time_us = struct.unpack_from("<BBHI", raw)
+            captures[-1].records.append((flags, rseq, time_us, raw[8 : 8 + length]))
+    return captures
+
+
+def describe(flags):
+    if flags & REC_TX:
+        src = "tx"
+    elif flags & REC_PANEL:
+        src = "panel"
+    else:
+        src = "heater"
+    state = "ok" if flags & REC_VALID else "bad"
+    if flags & REC_TRUNC:
+        state += ",trunc"
+    return src, state
+
+
+def snapshot_text(payload):
+    if len(payload) < SNAPSHOT.size:
+        return payload.hex(" ")
+    temp, setpoint, bath_time, flags, _, state = SNAPSHOT.unpack(payload)
+    on = [name for bit, name in enumerate(SNAP_FLAGS) if flags & (1 << bit)]
+    text = state.rstrip(b"\0").decode("ascii", "replace")
+    return (f"temp {(temp & 0x7FF) / 9:.1f} C, set {setpoint / 9:.0f} C, "
+            f"bath_time raw {bath_time & 0xFFF}, {' '.join(on) or '-'}"
+            + (f", '{text}'" if text else ""))
+
+
+def print_capture(cap):
+    when = f"unix {cap.unix_time}" if cap.unix_time else "clock not set"
+    detail = f" {cap.code:04X}={cap.data:08X}" if cap.reason == "code" else ""
+    print(f"# capture {cap.seq}: {cap.reason}{detail}, {when}, {len(cap.records)} records")
+    for i, (flags, _seq, time_us, payload) in enumerate(cap.records):
+        rel_us = ((time_us - cap.trigger_us + 0x80000000) & 0xFFFFFFFF) - 0x80000000
+        mark = ">" if i == cap.trigger_index else " "
+        if flags & REC_SNAPSHOT:
+            print(f"{mark}{rel_us / 1000:+11.3f}ms state  {snapshot_text(payload)}")
+        else:
+            src, state = describe(flags)
+            print(f"{mark}{rel_us / 1000:+11.3f}ms {src:6s} {state:9s} {payload.hex(' ')}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file", help="partition image or ESPHome log")
+    parser.add_argument("--raw", metavar="DIR", help="write wire bytes per capture to DIR")
+    parser.add_argument("--seq", type=int, help="only this capture")
+    args = parser.parse_args()
+
+    with open(args.file, "rb") as f:
+        blob = f.read()
+    if b"recorder: cap" in blob:
+        captures = parse_log(blob.decode("utf-8", "replace"))
+    else:
+        captures = parse_image(blob)
+    if args.seq is not None:
+        captures = [c for c in captures if c.seq == args.seq]
+    if not captures:
+        sys.exit("no captures found")
+
+    for cap in sorted(captures, key=lambda c: c.seq):
+        print_capture(cap)
+        if args.raw:
+            os.makedirs(args.raw, exist_ok=True)
+            path = os.path.join(args.raw, f"capture_{cap.seq}.bin")
+            with open(path, "wb") as out:
+                for flags, _seq, _time_us, payload in cap.records:
+                    if not flags & REC_SNAPSHOT:
+                        out.write(payload)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+"""Client for the sauna360 frame stream (``frame_stream:`` in YAML).
+
+Connects to the ESP, prints one line per frame and reports sequence gaps
+(frames the device dropped because this client fell behind).
+
+    sauna360_stream_client.py sauna.local
+    sauna360_stream_client.py 192.168.1.50 --port 6638 --raw capture.bin
+
+With ``--raw`` the unmodified wire bytes of every received frame are
+appended to a file, in the same format as a UART capture.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+
+MAGIC = b"S360"
+VERSION = 1
+HEADER = struct.Struct("<BBHI")
+
+FLAG_VALID = 0x01
+FLAG_PANEL = 0x02
+FLAG_TX = 0x04
+FLAG_TRUNC = 0x08
+
+
+def read_exact(sock, n):
+    buf = bytearray()
+    while len(buf) < n:
+        chunk = sock.recv(n - len(buf))
+        if not chunk:
+            raise ConnectionError("connection closed")
+        buf += chunk
+    return bytes(buf)
+
+
+def describe(flags):
+    if flags & FLAG_TX:
+        src = "tx"
+    elif flags & FLAG_PANEL:
+        src = "panel"
+    else:
+        src = "heater"
+    state = "ok" if flags & FLAG_VALID else "bad"
+    if flags & FLAG_TRUNC:
+        state += ",trunc"
+    return src, state
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=6638)
+    parser.add_argument("--raw", metavar="FILE", help="append wire bytes to FILE")
+    parser.add_argument("--quiet", action="store_true", help="only report gaps")
+    args = parser.parse_args()
+
+    raw = open(args.raw, "ab") if args.raw else None
+    sock = socket.create_connection((args.host, args.port))
+    hello = read_exact(sock, 5)
+    if hello[:4] != MAGIC or hello[4] != VERSION:
+        sys.exit(f"unexpected greeting {hello.hex()}")
+
+    expected = None
+    last_us = None
+    frames = lost = 0
+    try:
+        while True:
+            length, flags, seq, time_us = HEADER.unpack(read_exact(sock, HEADER.size))
+            data = read_exact(sock, length)
+            frames += 1
+            if expected is not None and seq != expected:
+                gap = (seq - expected) & 0xFFFF
+                lost += gap
+                print(f"# {gap} frame(s) dropped by device", flush=True)
+            expected = (seq + 1) & 0xFFFF
+            delta = 0 if last_us is None else (time_us - last_us) & 0xFFFFFFFF
+            last_us = time_us
+            if raw:
+                raw.write(data)
+            if not args.quiet:
+                src, state = describe(flags)
+                print(
+                    f"{time_us:10d} +{delta:8d}us {src:6s} {state:9s} {data.hex(' ')}",
+                    flush=True,
+                )
+    except (ConnectionError, KeyboardInterrupt) as err:
+        print(f"# {err or 'interrupted'}: {frames} frames, {lost} dropped", file=sys.stderr)
+    finally:
+        sock.close()
+        if raw:
+            raw.close()
+
+
+if __name__ == "__main__":
+    main()